@@ -0,0 +1,161 @@
+#include "AllocationTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Counters of every tag, index 0 is for untagged allocations
+// Tags are only added, never removed, so indices stay valid
+static std::atomic<const char*> tags[ALLOCATION_MAX_TAGS];
+static std::atomic<uint64_t> allocations[ALLOCATION_MAX_TAGS];
+static std::atomic<uint64_t> allocatedBytes[ALLOCATION_MAX_TAGS];
+static std::atomic<uint64_t> frees[ALLOCATION_MAX_TAGS];
+
+// Counters at the start of the frame
+static uint64_t frameAllocations[ALLOCATION_MAX_TAGS];
+static uint64_t frameAllocatedBytes[ALLOCATION_MAX_TAGS];
+static uint64_t frameFrees[ALLOCATION_MAX_TAGS];
+
+// Tag and allocations of each thread
+static thread_local const char* threadTag = nullptr;
+static thread_local unsigned int threadTagIndex = 0;
+static thread_local uint64_t threadAllocations = 0;
+
+// Return index of tag, adds it if it's new
+// Returns 0 (untagged) if there are too many tags
+static unsigned int getTagIndex(const char* tag)
+{
+	if (!tag)
+		return 0;
+
+	for (unsigned int i = 1; i < ALLOCATION_MAX_TAGS; ++i) {
+		const char* expected = nullptr;
+		if (tags[i].compare_exchange_strong(expected, tag) || expected == tag)
+			return i;
+	}
+	return 0;
+}
+
+// Make report from counters, optionally minus counters at the start of the frame
+static std::vector<AllocationStats> makeReport(const bool sinceFrameStart)
+{
+	std::vector<AllocationStats> report;
+	for (unsigned int i = 0; i < ALLOCATION_MAX_TAGS; ++i) {
+		AllocationStats stats;
+		if (i > 0) {
+			stats.tag = tags[i].load();
+			if (!stats.tag)
+				break;
+		}
+		stats.allocations = allocations[i].load(std::memory_order_relaxed) - (sinceFrameStart ? frameAllocations[i] : 0);
+		stats.bytes = allocatedBytes[i].load(std::memory_order_relaxed) - (sinceFrameStart ? frameAllocatedBytes[i] : 0);
+		stats.frees = frees[i].load(std::memory_order_relaxed) - (sinceFrameStart ? frameFrees[i] : 0);
+		if (stats.allocations > 0 || stats.frees > 0)
+			report.push_back(stats);
+	}
+	return report;
+}
+
+// Start a new frame, following report only counts allocations since now
+void AllocationTracker::beginFrame()
+{
+	for (unsigned int i = 0; i < ALLOCATION_MAX_TAGS; ++i) {
+		frameAllocations[i] = allocations[i].load(std::memory_order_relaxed);
+		frameAllocatedBytes[i] = allocatedBytes[i].load(std::memory_order_relaxed);
+		frameFrees[i] = frees[i].load(std::memory_order_relaxed);
+	}
+}
+// Allocations of every subsystem since the start of the frame, subsystems without allocations are skipped
+std::vector<AllocationStats> AllocationTracker::getFrameReport()
+{
+	return makeReport(true);
+}
+
+// Allocations of every subsystem since the start of the program
+std::vector<AllocationStats> AllocationTracker::getTotalReport()
+{
+	return makeReport(false);
+}
+
+// Number of allocations made by current thread since the start of the program
+uint64_t AllocationTracker::getThreadAllocations()
+{
+	return threadAllocations;
+}
+
+// Set tag of current thread, returns previous tag
+const char* AllocationTracker::setThreadTag(const char* tag)
+{
+	const auto previous = threadTag;
+	threadTag = tag;
+	threadTagIndex = getTagIndex(tag);
+	return previous;
+}
+
+// Called from operator new and delete
+void AllocationTracker::onAllocation(const unsigned int tagIndex, const uint64_t bytes)
+{
+	allocations[tagIndex].fetch_add(1, std::memory_order_relaxed);
+	allocatedBytes[tagIndex].fetch_add(bytes, std::memory_order_relaxed);
+	++threadAllocations;
+}
+void AllocationTracker::onFree(const unsigned int tagIndex, const uint64_t bytes)
+{
+	frees[tagIndex].fetch_add(1, std::memory_order_relaxed);
+}
+// Index of current thread's tag
+unsigned int AllocationTracker::getThreadTagIndex()
+{
+	return threadTagIndex;
+}
+
+#if ALLOCATION_TRACKING
+// Global operator new and delete that count everything
+// Every block starts with a header, so that delete knows its size and tag
+// Header is 16 bytes, so blocks keep alignment of malloc
+struct AllocationHeader
+{
+	uint64_t size;
+	uint64_t tagIndex;
+};
+
+static void* trackedAllocate(const std::size_t size)
+{
+	auto header = static_cast<AllocationHeader*>(std::malloc(sizeof(AllocationHeader) + size));
+	if (!header)
+		return nullptr;
+	header->size = size;
+	header->tagIndex = AllocationTracker::getThreadTagIndex();
+	AllocationTracker::onAllocation(static_cast<unsigned int>(header->tagIndex), size);
+	return header + 1;
+}
+static void trackedFree(void* pointer)
+{
+	if (!pointer)
+		return;
+	auto header = static_cast<AllocationHeader*>(pointer) - 1;
+	AllocationTracker::onFree(static_cast<unsigned int>(header->tagIndex), header->size);
+	std::free(header);
+}
+
+void* operator new(std::size_t size)
+{
+	if (auto pointer = trackedAllocate(size))
+		return pointer;
+	throw std::bad_alloc();
+}
+void* operator new[](std::size_t size)
+{
+	if (auto pointer = trackedAllocate(size))
+		return pointer;
+	throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size); }
+void operator delete(void* pointer) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { trackedFree(pointer); }
+#endif
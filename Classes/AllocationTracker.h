@@ -0,0 +1,93 @@
+#ifndef __ALLOCATION_TRACKER_H__
+#define __ALLOCATION_TRACKER_H__
+
+#include <cstdint>
+#include <vector>
+
+// Counts all allocations made with operator new, grouped by subsystem
+// Opt-in: build with ALLOCATION_TRACKING=1 (CMake option ALLOCATION_TRACKING) to replace global operator new and delete
+// When disabled, ALLOCATION_SCOPE is compiled out and all counters stay zero
+#ifndef ALLOCATION_TRACKING
+#define ALLOCATION_TRACKING 0
+#endif
+
+// Subsystems that can be told apart, allocations of further subsystems are counted as untagged
+#define ALLOCATION_MAX_TAGS 32
+// Name of allocations outside of any scope
+#define ALLOCATION_UNTAGGED "Other"
+
+// Allocations of one subsystem
+struct AllocationStats
+{
+	const char* tag = ALLOCATION_UNTAGGED;
+	uint64_t allocations = 0;
+	uint64_t bytes = 0;
+	uint64_t frees = 0;
+};
+
+// Global allocation counters
+// Tags should be string literals, they are compared as pointers
+class AllocationTracker
+{
+public:
+	// Start a new frame, following report only counts allocations since now
+	static void beginFrame();
+	// Allocations of every subsystem since the start of the frame, subsystems without allocations are skipped
+	static std::vector<AllocationStats> getFrameReport();
+
+	// Allocations of every subsystem since the start of the program
+	static std::vector<AllocationStats> getTotalReport();
+
+	// Number of allocations made by current thread since the start of the program
+	// Compare before and after some code to check that it doesn't allocate
+	static uint64_t getThreadAllocations();
+
+	// Set tag of current thread, returns previous tag
+	// Used by AllocationScope
+	static const char* setThreadTag(const char* tag);
+
+	// Called from operator new and delete
+	static void onAllocation(unsigned int tagIndex, uint64_t bytes);
+	static void onFree(unsigned int tagIndex, uint64_t bytes);
+	// Index of current thread's tag
+	static unsigned int getThreadTagIndex();
+
+	AllocationTracker() = delete; // We don't want instances of this class
+};
+
+// Tags all allocations of current thread until destruction
+// Scopes can be nested, inner tag wins
+class AllocationScope
+{
+public:
+	explicit AllocationScope(const char* tag) : previous_(AllocationTracker::setThreadTag(tag)) {}
+	~AllocationScope() { AllocationTracker::setThreadTag(previous_); }
+
+	AllocationScope(const AllocationScope&) = delete;
+	AllocationScope& operator=(const AllocationScope&) = delete;
+
+private:
+	const char* previous_;
+};
+
+// Counts allocations of current thread during its lifetime
+// E.g. to check that steady-state physics step doesn't allocate:
+//   AllocationCounter counter; world->step(dT); assert(counter.getAllocations() == 0);
+class AllocationCounter
+{
+public:
+	AllocationCounter() : start_(AllocationTracker::getThreadAllocations()) {}
+	uint64_t getAllocations() const { return AllocationTracker::getThreadAllocations() - start_; }
+
+private:
+	uint64_t start_;
+};
+
+// Tag allocations of the rest of current scope
+#if ALLOCATION_TRACKING
+#define ALLOCATION_SCOPE(tag) AllocationScope allocationScope(tag)
+#else
+#define ALLOCATION_SCOPE(tag)
+#endif
+
+#endif // __ALLOCATION_TRACKER_H__
@@ -1,5 +1,10 @@
 #include "AppDelegate.h"
 #include "SplashScene.h"
+#include "Definitions.h"
+#include "Trace.h"
+#include "AllocationTracker.h"
+#include "AudioManager.h"
+#include "ArchiveFileUtils.h"
 
 #include "audio/include/SimpleAudioEngine.h"
 using namespace CocosDenshion;
@@ -11,6 +16,10 @@ static cocos2d::Size designResolutionSize = cocos2d::Size(1920, 1080);
 AppDelegate::~AppDelegate() 
 {
     SimpleAudioEngine::end();
+
+#if TRACING
+    Trace::writeJson(tracePath_);
+#endif
 }
 
 // If you want a different context, modify the value of glContextAttrs
@@ -23,6 +32,60 @@ void AppDelegate::initGLContextAttrs()
     GLView::setGLContextAttrs(glContextAttrs);
 }
 
+#if TRACING
+// Trace main loop: update (all schedules, including physics), visit and draw of every frame
+// Director doesn't update while paused, then only draw is traced
+static void traceMainLoop(EventDispatcher* dispatcher)
+{
+    static uint64_t updateStart = 0;
+    static uint64_t visitStart = 0;
+    static uint64_t drawStart = 0;
+    static bool updated = false;
+
+    dispatcher->addCustomEventListener(Director::EVENT_BEFORE_UPDATE, [](EventCustom*) {
+        updateStart = Trace::now();
+        updated = true;
+    });
+    dispatcher->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [](EventCustom*) {
+        visitStart = Trace::now();
+        Trace::complete("Update", updateStart, visitStart - updateStart);
+    });
+    dispatcher->addCustomEventListener(Director::EVENT_AFTER_VISIT, [](EventCustom*) {
+        drawStart = Trace::now();
+        if (updated)
+            Trace::complete("Visit", visitStart, drawStart - visitStart);
+    });
+    dispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [](EventCustom*) {
+        const auto end = Trace::now();
+        Trace::complete("Draw", drawStart, end - drawStart);
+        if (updated)
+            Trace::complete("Frame", updateStart, end - updateStart);
+        updated = false;
+    });
+}
+#endif
+
+#if ALLOCATION_TRACKING
+// Log allocations of every subsystem in frames that are over budget
+static void reportFrameAllocations(EventDispatcher* dispatcher)
+{
+    AllocationTracker::beginFrame();
+    dispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [](EventCustom*) {
+        const auto report = AllocationTracker::getFrameReport();
+        uint64_t allocations = 0;
+        for (const auto& stats : report)
+            allocations += stats.allocations;
+        if (allocations > ALLOCATION_FRAME_BUDGET) {
+            CCLOG("Frame allocations: %llu (budget %d)", static_cast<unsigned long long>(allocations), ALLOCATION_FRAME_BUDGET);
+            for (const auto& stats : report)
+                CCLOG("  %s: %llu allocations, %llu bytes, %llu frees", stats.tag, static_cast<unsigned long long>(stats.allocations),
+                    static_cast<unsigned long long>(stats.bytes), static_cast<unsigned long long>(stats.frees));
+        }
+        AllocationTracker::beginFrame();
+    });
+}
+#endif
+
 // If you want to use the package manager to install more packages,  
 // Don't modify or remove this function
 static int register_all_packages()
@@ -32,6 +95,11 @@ static int register_all_packages()
 
 bool AppDelegate::applicationDidFinishLaunching() 
 {
+#if ASSET_ARCHIVE_SUPPORTED
+    // Read resources from the packed archive if the build made one
+    ArchiveFileUtils::install(ASSET_ARCHIVE_FILE);
+#endif
+
     // Initialize director
     auto director = Director::getInstance();
     auto glview = director->getOpenGLView();
@@ -54,6 +122,20 @@ bool AppDelegate::applicationDidFinishLaunching()
 
     register_all_packages();
 
+#if TRACING
+    // Timeline is saved on exit
+    tracePath_ = FileUtils::getInstance()->getWritablePath() + TRACE_FILE;
+    traceMainLoop(director->getEventDispatcher());
+#endif
+#if ALLOCATION_TRACKING
+    reportFrameAllocations(director->getEventDispatcher());
+#endif
+
+    // Free voices of finished sound effects, also while paused
+    director->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_DRAW, [](EventCustom*) {
+        AudioManager::getInstance()->update(Director::getInstance()->getDeltaTime());
+    });
+
     // Create a scene. It's an autorelease object
 	const auto scene = SplashScene::createScene();
 
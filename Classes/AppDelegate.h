@@ -34,6 +34,10 @@ public:
     @param  the pointer of the application
     */
     virtual void applicationWillEnterForeground() override;
+
+private:
+    // Where timeline is saved on exit (if tracing is enabled)
+    std::string tracePath_;
 };
 
 #endif // _APP_DELEGATE_H_
@@ -0,0 +1,70 @@
+#include "ArchiveFileUtils.h"
+
+#if ASSET_ARCHIVE_SUPPORTED
+
+USING_NS_CC;
+
+ArchiveFileUtils* ArchiveFileUtils::instance_ = nullptr;
+
+// Make FileUtils read from archive file in resources, returns false (and changes nothing) if there is no valid archive
+bool ArchiveFileUtils::install(const std::string& archiveFile)
+{
+	auto fileUtils = new ArchiveFileUtils();
+	fileUtils->init();
+	fileUtils->root_ = fileUtils->_defaultResRootPath;
+	if (!fileUtils->archive_.open(fileUtils->root_ + archiveFile)) {
+		delete fileUtils;
+		return false;
+	}
+
+	// Deletes the default instance
+	FileUtils::setDelegate(fileUtils);
+	instance_ = fileUtils;
+	CCLOG("Reading %u files from %s", fileUtils->archive_.getFileCount(), archiveFile.c_str());
+	return true;
+}
+
+// Return data of a file stored uncompressed in the archive, right from the mapping, nullptr otherwise
+const unsigned char* ArchiveFileUtils::getMappedData(const std::string& fullPath, size_t* size) const
+{
+	const auto entry = findEntry(fullPath);
+	if (!entry)
+		return nullptr;
+	*size = entry->size;
+	return archive_.getData(*entry);
+}
+
+// Return archive entry of a full path, nullptr if it isn't in the archive
+const AssetArchive::Entry* ArchiveFileUtils::findEntry(const std::string& fullPath) const
+{
+	if (fullPath.compare(0, root_.size(), root_) != 0)
+		return nullptr;
+	return archive_.find(fullPath.substr(root_.size()));
+}
+
+// FileUtils
+bool ArchiveFileUtils::isFileExistInternal(const std::string& filePath) const
+{
+	return findEntry(filePath) || PlatformFileUtils::isFileExistInternal(filePath);
+}
+long ArchiveFileUtils::getFileSize(const std::string& filePath)
+{
+	const auto entry = findEntry(fullPathForFilename(filePath));
+	if (!entry)
+		return PlatformFileUtils::getFileSize(filePath);
+	return static_cast<long>(entry->size);
+}
+FileUtils::Status ArchiveFileUtils::getContents(const std::string& filename, ResizableBuffer* buffer)
+{
+	// getDataFromFile and getStringFromFile read through this
+	const auto entry = filename.empty() ? nullptr : findEntry(fullPathForFilename(filename));
+	if (!entry)
+		return PlatformFileUtils::getContents(filename, buffer);
+
+	buffer->resize(entry->size);
+	if (entry->size > 0 && !archive_.read(*entry, static_cast<unsigned char*>(buffer->buffer())))
+		return Status::ReadFailed;
+	return Status::OK;
+}
+
+#endif
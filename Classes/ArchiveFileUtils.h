@@ -0,0 +1,54 @@
+#ifndef __ARCHIVE_FILE_UTILS_H__
+#define __ARCHIVE_FILE_UTILS_H__
+
+#include "cocos2d.h"
+#include "AssetArchive.h"
+#include <string>
+
+// Archive is only read on desktop, other platforms have their own packages
+#define ASSET_ARCHIVE_SUPPORTED (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+
+#if ASSET_ARCHIVE_SUPPORTED
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+#include "platform/win32/CCFileUtils-win32.h"
+typedef cocos2d::FileUtilsWin32 PlatformFileUtils;
+#else
+#include "platform/linux/CCFileUtils-linux.h"
+typedef cocos2d::FileUtilsLinux PlatformFileUtils;
+#endif
+
+// FileUtils that serves resources from the packed asset archive
+// Files that aren't in the archive (sounds, writable path, new files) are read the usual way
+// Lookups don't touch the disk, the archive is mapped once and its index is binary searched
+class ArchiveFileUtils : public PlatformFileUtils
+{
+public:
+	// Make FileUtils read from archive file in resources, returns false (and changes nothing) if there is no valid archive
+	static bool install(const std::string& archiveFile);
+	// Return installed instance, nullptr if there is no archive
+	static ArchiveFileUtils* getInstance() { return instance_; }
+
+	// Return data of a file stored uncompressed in the archive, right from the mapping, nullptr otherwise
+	// Data stays valid for the whole run
+	const unsigned char* getMappedData(const std::string& fullPath, size_t* size) const;
+
+	// FileUtils
+	virtual bool isFileExistInternal(const std::string& filePath) const override;
+	virtual long getFileSize(const std::string& filePath) override;
+	virtual Status getContents(const std::string& filename, cocos2d::ResizableBuffer* buffer) override;
+
+private:
+	// Return archive entry of a full path, nullptr if it isn't in the archive
+	const AssetArchive::Entry* findEntry(const std::string& fullPath) const;
+
+	// Mapped archive
+	AssetArchive archive_;
+	// Resources directory, full paths in it are looked up in the archive
+	std::string root_;
+
+	// Installed instance
+	static ArchiveFileUtils* instance_;
+};
+#endif
+
+#endif // __ARCHIVE_FILE_UTILS_H__
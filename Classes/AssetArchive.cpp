@@ -0,0 +1,257 @@
+#include "AssetArchive.h"
+#include "cocos2d.h"
+#include "Definitions.h"
+#include <zlib.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+USING_NS_CC;
+
+// Compare path of entry with file, like std::string::compare
+static int comparePath(const unsigned char* mapping, const AssetArchive::Entry& entry, const std::string& file)
+{
+	const auto result = std::memcmp(mapping + entry.pathOffset, file.data(), std::min<size_t>(entry.pathLength, file.size()));
+	if (result != 0)
+		return result;
+	return entry.pathLength < file.size() ? -1 : (entry.pathLength > file.size() ? 1 : 0);
+}
+
+// Map archive file, returns false if it can't be mapped or isn't a valid archive
+bool AssetArchive::open(const std::string& path)
+{
+	close();
+
+#ifdef _WIN32
+	std::wstring widePath(MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0), L'\0');
+	MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &widePath[0], static_cast<int>(widePath.size()));
+	const auto file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+	const auto mappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	const auto view = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (!view) {
+		if (mappingHandle)
+			CloseHandle(mappingHandle);
+		CloseHandle(file);
+		return false;
+	}
+	file_ = file;
+	mappingHandle_ = mappingHandle;
+	mapping_ = static_cast<const unsigned char*>(view);
+	size_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+	const auto file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size == 0) {
+		::close(file);
+		return false;
+	}
+	const auto view = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	::close(file); // mapping stays valid
+	if (view == MAP_FAILED)
+		return false;
+	// The whole archive is read ahead in one sequential read, instead of one read per file when it is used
+	madvise(view, status.st_size, MADV_WILLNEED);
+	mapping_ = static_cast<const unsigned char*>(view);
+	size_ = static_cast<size_t>(status.st_size);
+#endif
+
+	// Check header, that index is sorted and that paths and data are inside the file
+	const auto header = reinterpret_cast<const Header*>(mapping_);
+	auto valid = size_ >= sizeof(Header) && std::memcmp(header->magic, ASSET_ARCHIVE_MAGIC, sizeof(header->magic)) == 0
+		&& header->version == ASSET_ARCHIVE_VERSION && header->count <= (size_ - sizeof(Header)) / sizeof(Entry);
+	if (valid) {
+		entries_ = reinterpret_cast<const Entry*>(mapping_ + sizeof(Header));
+		count_ = header->count;
+	}
+	for (uint32_t i = 0; valid && i < count_; ++i) {
+		const auto& entry = entries_[i];
+		valid = entry.pathOffset + static_cast<uint64_t>(entry.pathLength) <= size_ && entry.dataOffset <= size_ && entry.packedSize <= size_ - entry.dataOffset;
+		if (valid && i > 0) {
+			const auto& previous = entries_[i - 1];
+			valid = comparePath(mapping_, entry, std::string(reinterpret_cast<const char*>(mapping_) + previous.pathOffset, previous.pathLength)) > 0;
+		}
+	}
+	if (!valid) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+// Unmap archive
+void AssetArchive::close()
+{
+	if (!mapping_)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(mapping_);
+	CloseHandle(mappingHandle_);
+	CloseHandle(file_);
+	file_ = nullptr;
+	mappingHandle_ = nullptr;
+#else
+	munmap(const_cast<unsigned char*>(mapping_), size_);
+#endif
+	mapping_ = nullptr;
+	size_ = 0;
+	entries_ = nullptr;
+	count_ = 0;
+}
+
+// Return entry of file (path relative to resources, e.g. "fonts/font.ttf"), nullptr if it isn't in the archive
+const AssetArchive::Entry* AssetArchive::find(const std::string& file) const
+{
+	const auto end = entries_ + count_;
+	const auto foundIt = std::lower_bound(entries_, end, file, [this](const Entry& entry, const std::string& file) {
+		return comparePath(mapping_, entry, file) < 0;
+	});
+	if (foundIt == end || comparePath(mapping_, *foundIt, file) != 0)
+		return nullptr;
+	return foundIt;
+}
+
+// Return data of a stored entry in the mapping, nullptr if it is compressed
+const unsigned char* AssetArchive::getData(const Entry& entry) const
+{
+	if (entry.packedSize != entry.size)
+		return nullptr;
+	return mapping_ + entry.dataOffset;
+}
+
+// Copy or unpack entry into buffer of entry.size bytes, returns false if compressed data is broken
+bool AssetArchive::read(const Entry& entry, unsigned char* buffer) const
+{
+	const auto data = mapping_ + entry.dataOffset;
+	if (entry.packedSize == entry.size) {
+		std::memcpy(buffer, data, entry.size);
+		return true;
+	}
+
+	uLongf size = entry.size;
+	return uncompress(buffer, &size, data, entry.packedSize) == Z_OK && size == entry.size;
+}
+
+// Make separators of path '/' and remove repeated ones
+static std::string normalizePath(std::string path)
+{
+	std::replace(path.begin(), path.end(), '\\', '/');
+	path.erase(std::unique(path.begin(), path.end(), [](const char a, const char b) { return a == '/' && b == '/'; }), path.end());
+	return path;
+}
+
+// Pack all files of directories into archive at path, files with skipped extensions (e.g. ".wav") are left out
+// A file of a later directory replaces the file with the same relative path of an earlier one (e.g. generated resources)
+// Throws invalid_argument if a file can't be read or the archive can't be written
+void AssetArchive::pack(const std::vector<std::string>& directories, const std::string& path, const std::vector<std::string>& skippedExtensions)
+{
+	// Relative paths and roots of their directories
+	const auto fileUtils = FileUtils::getInstance();
+	std::map<std::string, std::string> found;
+	for (const auto& directory : directories) {
+		auto root = normalizePath(fileUtils->fullPathForFilename(directory));
+		if (root.empty() || !fileUtils->isDirectoryExist(root))
+			throw std::invalid_argument("can't find directory " + directory);
+		if (root.back() != '/')
+			root += '/';
+
+		std::vector<std::string> listed;
+		fileUtils->listFilesRecursively(root, &listed);
+		for (auto file : listed) {
+			file = normalizePath(file);
+			if (file.back() == '/' || file.compare(0, root.size(), root) != 0 || file.compare(root.size(), std::string::npos, ASSET_ARCHIVE_FILE) == 0)
+				continue; // directories and an archive packed into the directory before
+			const auto extension = fileUtils->getFileExtension(file);
+			if (std::find(skippedExtensions.begin(), skippedExtensions.end(), extension) != skippedExtensions.end())
+				continue;
+			found[file.substr(root.size())] = root;
+		}
+	}
+
+	// Sorted for binary search
+	std::vector<std::string> files;
+	std::vector<std::string> roots;
+	files.reserve(found.size());
+	roots.reserve(found.size());
+	for (const auto& file : found) {
+		files.push_back(file.first);
+		roots.push_back(file.second);
+	}
+
+	// Read files and compress those that get small enough
+	std::vector<std::vector<unsigned char>> contents(files.size());
+	std::vector<Entry> entries(files.size());
+	for (size_t i = 0; i < files.size(); ++i) {
+		std::ifstream stream(roots[i] + files[i], std::ios::binary);
+		if (!stream)
+			throw std::invalid_argument("can't read " + roots[i] + files[i]);
+		std::vector<unsigned char> content((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+		entries[i].size = static_cast<uint32_t>(content.size());
+		entries[i].packedSize = entries[i].size;
+
+		auto packedSize = compressBound(static_cast<uLong>(content.size()));
+		std::vector<unsigned char> packed(packedSize);
+		if (!content.empty() && compress2(packed.data(), &packedSize, content.data(), static_cast<uLong>(content.size()), Z_BEST_COMPRESSION) == Z_OK
+			&& packedSize <= content.size() * (1 - ASSET_ARCHIVE_MIN_SAVING)) {
+			packed.resize(packedSize);
+			content = std::move(packed);
+			entries[i].packedSize = static_cast<uint32_t>(packedSize);
+		}
+		contents[i] = std::move(content);
+	}
+
+	// Offsets of paths and aligned data
+	const auto align = [](const uint64_t offset) { return (offset + ASSET_ARCHIVE_ALIGNMENT - 1) / ASSET_ARCHIVE_ALIGNMENT * ASSET_ARCHIVE_ALIGNMENT; };
+	uint64_t offset = sizeof(Header) + files.size() * sizeof(Entry);
+	for (size_t i = 0; i < files.size(); ++i) {
+		entries[i].pathOffset = static_cast<uint32_t>(offset);
+		entries[i].pathLength = static_cast<uint32_t>(files[i].size());
+		offset += files[i].size();
+	}
+	for (size_t i = 0; i < files.size(); ++i) {
+		entries[i].dataOffset = align(offset);
+		offset = entries[i].dataOffset + entries[i].packedSize;
+	}
+
+	// Write
+	std::ofstream stream(path, std::ios::binary);
+	Header header = {};
+	std::memcpy(header.magic, ASSET_ARCHIVE_MAGIC, sizeof(header.magic));
+	header.version = ASSET_ARCHIVE_VERSION;
+	header.count = static_cast<uint32_t>(files.size());
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	stream.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+	for (const auto& file : files)
+		stream.write(file.data(), file.size());
+	const char padding[ASSET_ARCHIVE_ALIGNMENT] = {};
+	for (size_t i = 0; i < files.size(); ++i) {
+		stream.write(padding, static_cast<std::streamsize>(entries[i].dataOffset - static_cast<uint64_t>(stream.tellp())));
+		stream.write(reinterpret_cast<const char*>(contents[i].data()), contents[i].size());
+	}
+	if (!stream)
+		throw std::invalid_argument("can't write " + path);
+}
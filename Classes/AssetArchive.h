@@ -0,0 +1,78 @@
+#ifndef __ASSET_ARCHIVE_H__
+#define __ASSET_ARCHIVE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// All resources packed into one file, read through a memory mapping
+// Layout: header, index sorted by path, paths, then data of files aligned to ASSET_ARCHIVE_ALIGNMENT
+// Files are zlib compressed only if it saves enough, others are stored as they are and used right from the mapping
+// Numbers are little-endian, like on all our platforms
+// Written by the asset_packer tool, read by ArchiveFileUtils
+// Reading is thread-safe, the mapping never changes
+class AssetArchive
+{
+public:
+	// Index entry of a file
+	struct Entry
+	{
+		uint32_t pathOffset; // from the start of the archive
+		uint32_t pathLength;
+		uint64_t dataOffset; // from the start of the archive
+		uint32_t packedSize; // equal to size for stored files
+		uint32_t size;
+	};
+
+	// Map archive file, returns false if it can't be mapped or isn't a valid archive
+	bool open(const std::string& path);
+	// Unmap archive
+	void close();
+	// Whether an archive is mapped
+	bool isOpen() const { return mapping_ != nullptr; }
+
+	// Return entry of file (path relative to resources, e.g. "fonts/font.ttf"), nullptr if it isn't in the archive
+	const Entry* find(const std::string& file) const;
+	// Return data of a stored entry in the mapping, nullptr if it is compressed
+	const unsigned char* getData(const Entry& entry) const;
+	// Copy or unpack entry into buffer of entry.size bytes, returns false if compressed data is broken
+	bool read(const Entry& entry, unsigned char* buffer) const;
+	// Return number of files
+	uint32_t getFileCount() const { return count_; }
+
+	// Pack all files of directories into archive at path, files with skipped extensions (e.g. ".wav") are left out
+	// A file of a later directory replaces the file with the same relative path of an earlier one (e.g. generated resources)
+	// Throws invalid_argument if a file can't be read or the archive can't be written
+	static void pack(const std::vector<std::string>& directories, const std::string& path, const std::vector<std::string>& skippedExtensions);
+
+	// Constructor and destructor
+	AssetArchive() = default;
+	~AssetArchive() { close(); }
+	AssetArchive(const AssetArchive&) = delete;
+	AssetArchive& operator=(const AssetArchive&) = delete;
+
+private:
+	// Start of the archive
+	struct Header
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t count; // of entries
+		uint32_t reserved;
+	};
+
+	// Mapped file
+	const unsigned char* mapping_ = nullptr;
+	size_t size_ = 0;
+#ifdef _WIN32
+	void* file_ = nullptr;
+	void* mappingHandle_ = nullptr;
+#endif
+
+	// Index in the mapping
+	const Entry* entries_ = nullptr;
+	uint32_t count_ = 0;
+};
+
+#endif // __ASSET_ARCHIVE_H__
@@ -0,0 +1,203 @@
+#include "AssetPreloader.h"
+#include "ParticleCache.h"
+#include "Definitions.h"
+#include "Trace.h"
+#include "ArchiveFileUtils.h"
+#include "base/base64.h"
+#include "base/ZipUtils.h"
+#include <algorithm>
+#include <cstdlib>
+
+USING_NS_CC;
+
+// Add assets, only before start
+void AssetPreloader::addImage(const std::string& file)
+{
+	if (!workers_.empty())
+		throw std::invalid_argument("can't add assets after start");
+	jobs_.push_back({ false, file, FileUtils::getInstance()->fullPathForFilename(file), nullptr, "", ValueMap() });
+	++totalCount_;
+}
+void AssetPreloader::addParticles(const std::string& file)
+{
+	if (!workers_.empty())
+		throw std::invalid_argument("can't add assets after start");
+	jobs_.push_back({ true, file, FileUtils::getInstance()->fullPathForFilename(file), nullptr, "", ValueMap() });
+	++totalCount_;
+}
+// Task that has to run on the main thread
+void AssetPreloader::addMainThreadTask(std::function<void()> task)
+{
+	mainThreadTasks_.push_back(std::move(task));
+	++totalCount_;
+}
+
+// Start worker threads
+void AssetPreloader::start()
+{
+	if (!workers_.empty() || jobs_.empty())
+		return;
+
+	const auto hardwareThreads = std::max(2u, std::thread::hardware_concurrency());
+	const auto threadCount = std::min({ static_cast<size_t>(hardwareThreads - 1), static_cast<size_t>(ASSET_PRELOADER_MAX_THREADS), jobs_.size() });
+	for (size_t i = 0; i < threadCount; ++i)
+		workers_.emplace_back(&AssetPreloader::work, this);
+}
+
+// Upload loaded assets and run main thread tasks, called every frame on the main thread
+void AssetPreloader::update()
+{
+	TRACE_SCOPE("AssetPreloader::update");
+
+	unsigned int steps = 0;
+
+	// Uploads
+	std::vector<Job> finished;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		const auto count = std::min(finishedJobs_.size(), static_cast<size_t>(ASSET_PRELOADER_STEPS_PER_FRAME));
+		std::move(finishedJobs_.begin(), finishedJobs_.begin() + count, std::back_inserter(finished));
+		finishedJobs_.erase(finishedJobs_.begin(), finishedJobs_.begin() + count);
+	}
+	for (auto& job : finished) {
+		finish(job);
+		++doneCount_;
+		++steps;
+	}
+
+	// Main thread tasks use the rest of the frame's steps
+	while (steps < ASSET_PRELOADER_STEPS_PER_FRAME && nextMainThreadTask_ < mainThreadTasks_.size()) {
+		mainThreadTasks_[nextMainThreadTask_++]();
+		++doneCount_;
+		++steps;
+	}
+}
+
+// Return part of assets that are ready, in [0, 1]
+float AssetPreloader::getProgress() const
+{
+	if (totalCount_ == 0)
+		return 1;
+	return static_cast<float>(doneCount_) / totalCount_;
+}
+
+// Take jobs until there are none
+void AssetPreloader::work()
+{
+	while (true) {
+		size_t index;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (stopping_ || nextJob_ >= jobs_.size())
+				return;
+			index = nextJob_++;
+		}
+
+		// jobs_ doesn't change after start, so the job can be used without the lock
+		load(jobs_[index]);
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		finishedJobs_.push_back(std::move(jobs_[index]));
+		jobs_[index].image = nullptr; // now owned by the finished job
+	}
+}
+
+// Decode image file, files stored in the asset archive are decoded right from its mapping without copying them
+static bool initImage(Image* image, const std::string& fullPath)
+{
+#if ASSET_ARCHIVE_SUPPORTED
+	size_t size = 0;
+	if (const auto archive = ArchiveFileUtils::getInstance())
+		if (const auto data = archive->getMappedData(fullPath, &size))
+			return image->initWithImageData(data, static_cast<ssize_t>(size));
+#endif
+	return image->initWithImageFile(fullPath);
+}
+
+// Load asset of job
+void AssetPreloader::load(Job& job)
+{
+	if (!job.isParticles) {
+		job.image = new Image();
+		job.textureKey = job.fullPath; // same key as TextureCache::addImage(file)
+		if (!initImage(job.image, job.fullPath)) {
+			job.image->release();
+			job.image = nullptr;
+		}
+		return;
+	}
+
+	job.particles = FileUtils::getInstance()->getValueMapFromFile(job.fullPath);
+	const auto textureNameIt = job.particles.find("textureFileName");
+	if (textureNameIt == job.particles.end())
+		return;
+	const auto textureName = textureNameIt->second.asString();
+
+	// Texture file next to the plist, like ParticleSystem looks for it
+	const auto directory = job.fullPath.substr(0, job.fullPath.rfind('/') + 1);
+	const auto texturePath = directory + textureName.substr(textureName.rfind('/') + 1);
+	job.image = new Image();
+	if (initImage(job.image, texturePath))
+		job.textureKey = texturePath;
+	else {
+		job.image->release();
+		job.image = nullptr;
+
+		// Texture embedded into the plist, base64 of gzipped image
+		const auto dataIt = job.particles.find("textureImageData");
+		if (dataIt == job.particles.end())
+			return;
+		const auto data = dataIt->second.asString();
+		unsigned char* decoded = nullptr;
+		const auto decodedLength = base64Decode(reinterpret_cast<const unsigned char*>(data.c_str()), static_cast<unsigned int>(data.size()), &decoded);
+		unsigned char* inflated = nullptr;
+		const auto inflatedLength = decoded ? ZipUtils::inflateMemory(decoded, decodedLength, &inflated) : 0;
+		if (inflated) {
+			job.image = new Image();
+			if (!job.image->initWithImageData(inflated, inflatedLength)) {
+				job.image->release();
+				job.image = nullptr;
+			}
+		}
+		free(decoded);
+		free(inflated);
+		if (!job.image)
+			return;
+
+		// Absolute paths are looked up in TextureCache as they are, so this key is found without decoding the data again
+		job.textureKey = job.fullPath + "/" + textureName;
+		job.particles.erase(dataIt);
+	}
+	job.particles["textureFileName"] = Value(job.textureKey);
+}
+
+// Upload asset of a finished job
+void AssetPreloader::finish(Job& job)
+{
+	// Assets that failed to load are loaded again when they are used
+	if (!job.image)
+		return;
+
+	Director::getInstance()->getTextureCache()->addImage(job.image, job.textureKey);
+	job.image->release();
+	job.image = nullptr;
+
+	if (job.isParticles)
+		ParticleCache::getInstance()->add(job.file, std::move(job.particles));
+}
+
+// Constructor
+AssetPreloader::AssetPreloader() : stopping_(false) {}
+
+// Destructor
+// Skips assets that weren't loaded yet and waits for workers
+AssetPreloader::~AssetPreloader()
+{
+	stopping_ = true;
+	for (auto& worker : workers_)
+		worker.join();
+
+	for (auto& job : finishedJobs_)
+		if (job.image)
+			job.image->release();
+}
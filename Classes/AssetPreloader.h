@@ -0,0 +1,77 @@
+#ifndef __ASSET_PRELOADER_H__
+#define __ASSET_PRELOADER_H__
+
+#include "cocos2d.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Loads assets during the splash screen, so that the first game doesn't hitch
+// Images are decoded and particle plists parsed (with their embedded textures) on worker threads
+// GPU uploads and main thread tasks (fonts, sounds) are done by update, at most ASSET_PRELOADER_STEPS_PER_FRAME per frame
+class AssetPreloader
+{
+public:
+	// Add assets, only before start
+	void addImage(const std::string& file);
+	void addParticles(const std::string& file);
+	// Task that has to run on the main thread
+	void addMainThreadTask(std::function<void()> task);
+
+	// Start worker threads
+	void start();
+	// Upload loaded assets and run main thread tasks, called every frame on the main thread
+	void update();
+
+	// Return part of assets that are ready, in [0, 1]
+	float getProgress() const;
+	// Whether all assets are ready
+	bool isDone() const { return doneCount_ == totalCount_; }
+
+	// Constructor
+	AssetPreloader();
+	// Destructor
+	// Skips assets that weren't loaded yet and waits for workers
+	~AssetPreloader();
+
+private:
+	// Asset loaded by a worker
+	struct Job
+	{
+		bool isParticles;
+		std::string file;
+		std::string fullPath; // FileUtils caches paths without locking, so they are found on the main thread
+		cocos2d::Image* image; // decoded texture
+		std::string textureKey; // of image in TextureCache
+		cocos2d::ValueMap particles; // parsed plist
+	};
+
+	// Take jobs until there are none
+	void work();
+	// Load asset of job
+	static void load(Job& job);
+	// Upload asset of a finished job
+	static void finish(Job& job);
+
+	// Workers
+	std::vector<std::thread> workers_;
+	std::atomic<bool> stopping_;
+
+	// Jobs, workers take them in order and move finished ones to finishedJobs_
+	std::mutex mutex_;
+	std::vector<Job> jobs_;
+	size_t nextJob_ = 0;
+	std::vector<Job> finishedJobs_;
+	// Main thread tasks, run in order
+	std::vector<std::function<void()>> mainThreadTasks_;
+	size_t nextMainThreadTask_ = 0;
+
+	// Progress
+	unsigned int totalCount_ = 0;
+	unsigned int doneCount_ = 0;
+};
+
+#endif // __ASSET_PRELOADER_H__
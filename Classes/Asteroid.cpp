@@ -1,6 +1,9 @@
 #include "Asteroid.h"
 #include "Physics/Physics.h"
 #include "Projectile.h"
+#include "EffectQueue.h"
+#include "SpriteManifest.h"
+#include "AsteroidBatch.h"
 #include "Definitions.h"
 
 #include "audio/include/SimpleAudioEngine.h"
@@ -16,34 +19,55 @@ void Asteroid::onHit(const PhysContact& contact)
 
 	if (sceneNode_) {
 		// Create particle
-		auto sparks = ParticleSystemQuad::create(ASTEROID_BOUNCED_PARTICLES);
-		sparks->setPosition(getPosition() + contact.getDirectionFrom(this) * asteroid_->getContentSize().width / 2);
-		sparks->setScale(asteroid_->getScale());
-		sceneNode_->addChild(sparks, rootNode_->getLocalZOrder());
+		effects_->addBurst(ASTEROID_BOUNCED_PARTICLES, zLevel_, getPosition() + contact.getDirectionFrom(this) * size_.width / 2, scale_);
 	}
 
 	Target::onHit(contact);
 }
 
+// Add an instance to the asteroid batch of the scene, asteroids don't have nodes
+void Asteroid::addToScene(Scene* scene, const int zLevel)
+{
+	attachToScene(scene);
+	zLevel_ = zLevel;
+	batch_ = AsteroidBatch::getFor(scene, zLevel);
+	instance_ = batch_->addInstance(getPosition(), scale_, getHealthColor());
+}
+
+// Move the instance
+void Asteroid::moveNodes(const Vec2& pos)
+{
+	if (batch_)
+		batch_->setInstancePosition(instance_, pos);
+}
+
 // Constructors
 Asteroid::Asteroid(const Vec2& pos, const float& scale, const Color3B& color) : Asteroid(pos, std::make_unique<PhysMovement>(), scale, color) {}
-Asteroid::Asteroid(const Vec2& pos, std::unique_ptr<PhysMovement> movement, const float& scale, const Color3B& color) : Target(pos, ASTEROID_MASS * scale * scale, ASTEROID_BOUNCINESS), color_(color)
+Asteroid::Asteroid(const Vec2& pos, std::unique_ptr<PhysMovement> movement, const float& scale, const Color3B& color) : Target(pos, ASTEROID_MASS * scale * scale, ASTEROID_BOUNCINESS), scale_(scale), color_(color)
 {
-	asteroid_ = Sprite::create();
-	asteroid_->initWithFile(ASTEROID_SPRITE);
-	asteroid_->setPosition(0, 0);
-	asteroid_->setScale(scale);
-	asteroid_->setColor(color_);
+	const auto& sprite = SpriteManifest::get(ASTEROID_SPRITE);
+	size_ = sprite.getSize();
 
-	rootNode_->addChild(asteroid_);
-
-	addCollider(std::make_unique<PhysCircleCollider>(asteroid_->getContentSize().width / 2 * scale, ASTEROID_BITMASKS));
+	addCollider(std::make_unique<PhysCircleCollider>(sprite.radius * scale_, ASTEROID_BITMASKS));
 	setMovement(std::move(movement));
 
 	healthPoints_ = ASTEROID_HP;
 }
 // Important for cleaning memory using base class pointer
-Asteroid::~Asteroid() = default;
+Asteroid::~Asteroid()
+{
+	if (batch_)
+		batch_->removeInstance(instance_);
+}
+
+// Remove the instance
+void Asteroid::onDestroy()
+{
+	Target::onDestroy();
+	if (batch_)
+		batch_->removeInstance(instance_);
+	batch_ = nullptr;
+}
 
 // Called on being hit (overlaped) by a Projectile
 void Asteroid::onBeingHit(Projectile* projectile, const Vec2& toProjectile)
@@ -55,18 +79,21 @@ void Asteroid::onBeingHit(Projectile* projectile, const Vec2& toProjectile)
 	if (healthPoints_ <= 1) {
 		if (sceneNode_) {
 			// Create particle
-			auto wreck = ParticleSystemQuad::create(ASTEROID_BREAK_PARTICLES);
-			wreck->setPosition(getPosition());
-			wreck->setColor(color_);
-			wreck->setScale(asteroid_->getScale());
-			sceneNode_->addChild(wreck, rootNode_->getLocalZOrder());
+			effects_->addBurst(ASTEROID_BREAK_PARTICLES, zLevel_, getPosition(), scale_, color_);
 		}
 
 		destroy();
 	}
 	else {
 		--healthPoints_;
-		const auto temp = static_cast<float>(healthPoints_) / ASTEROID_HP;
-		asteroid_->setColor(Color3B(color_.r * temp, color_.g * temp, color_.b * temp));
+		if (batch_)
+			batch_->setInstanceColor(instance_, getHealthColor());
 	}
 }
+
+// Color of the sprite darkened by lost health points
+Color3B Asteroid::getHealthColor() const
+{
+	const auto temp = static_cast<float>(healthPoints_) / ASTEROID_HP;
+	return Color3B(color_.r * temp, color_.g * temp, color_.b * temp);
+}
@@ -2,15 +2,22 @@
 #define __ASTEROID_H__
 
 #include "Target.h"
+#include "Physics/PhysPool.h"
+#include "AsteroidBatch.h"
 #include "cocos2d.h"
 
 // Represents an asteroid that can be destroyed
 class Asteroid : public Target
 {
+	PHYS_POOLED(Asteroid)
+
 public:
 	// Called on hits
 	virtual void onHit(const PhysContact& contact) override;
 
+	// Add an instance to the asteroid batch of the scene, asteroids don't have nodes
+	virtual void addToScene(cocos2d::Scene* scene, int zLevel) override;
+
 	// Constructors
 	explicit Asteroid(const cocos2d::Vec2& pos, const float& scale = 1, const cocos2d::Color3B& color = cocos2d::Color3B::WHITE);
 	Asteroid(const cocos2d::Vec2& pos, std::unique_ptr<PhysMovement> movement, const float& scale = 1, const cocos2d::Color3B& color = cocos2d::Color3B::WHITE);
@@ -21,14 +28,32 @@ protected:
 	// Called on being hit (overlaped) by a Projectile
 	virtual void onBeingHit(Projectile* projectile, const cocos2d::Vec2& toProjectile) override;
 
+	// Remove the instance
+	virtual void onDestroy() override;
+
+	// Move the instance
+	virtual void moveNodes(const cocos2d::Vec2& pos) override;
+
 private:
-	cocos2d::Sprite* asteroid_;
+	// Batch that draws the asteroid and instance in it
+	AsteroidBatch* batch_ = nullptr;
+	unsigned int instance_ = 0;
+	// Z level of the batch, hit effects are drawn at it
+	int zLevel_ = 0;
+
+	// Size of the sprite (not scaled), known even without a scene
+	cocos2d::Size size_;
+	// Scale of the sprite
+	float scale_;
 
 	// Number of times asteroid has to be hit
 	unsigned int healthPoints_;
 
 	// Color of the sprite
 	cocos2d::Color3B color_;
+
+	// Color of the sprite darkened by lost health points
+	cocos2d::Color3B getHealthColor() const;
 };
 
 #endif // __ASTEROID_H__
@@ -0,0 +1,165 @@
+#include "AsteroidBatch.h"
+#include "SpriteManifest.h"
+#include "TransformSync.h"
+#include "Definitions.h"
+
+USING_NS_CC;
+
+// Return batch of the scene, creates it on first use
+AsteroidBatch* AsteroidBatch::getFor(Scene* scene, const int zOrder)
+{
+	if (!scene)
+		throw std::invalid_argument("scene can't be nullptr");
+
+	const auto name = std::string(ASTEROID_SPRITE) + "#" + std::to_string(zOrder);
+	auto batch = dynamic_cast<AsteroidBatch*>(scene->getChildByName(name));
+	if (!batch) {
+		batch = AsteroidBatch::create();
+		batch->setName(name);
+		batch->transformSync_ = TransformSync::getFor(scene);
+		scene->addChild(batch, zOrder);
+	}
+	return batch;
+}
+
+// Add/remove an instance, returns its handle
+unsigned int AsteroidBatch::addInstance(const Vec2& pos, const float scale, const Color3B& color)
+{
+	unsigned int instance;
+	if (!freeHandles_.empty()) {
+		instance = freeHandles_.back();
+		freeHandles_.pop_back();
+	}
+	else {
+		instance = static_cast<unsigned int>(indices_.size());
+		indices_.emplace_back();
+	}
+
+	indices_[instance] = static_cast<unsigned int>(x_.size());
+	handles_.push_back(instance);
+	x_.push_back(pos.x);
+	y_.push_back(pos.y);
+	halfWidth_.push_back(size_.width * scale / 2);
+	halfHeight_.push_back(size_.height * scale / 2);
+	colors_.emplace_back(color);
+
+	// Texture coordinates never change, so they are only set for new quads
+	if (quads_.size() < x_.size()) {
+		quads_.emplace_back();
+		auto& quad = quads_.back();
+		quad.bl.texCoords = Tex2F(texCoordsMin_.u, texCoordsMax_.v);
+		quad.br.texCoords = texCoordsMax_;
+		quad.tl.texCoords = texCoordsMin_;
+		quad.tr.texCoords = Tex2F(texCoordsMax_.u, texCoordsMin_.v);
+		left_.emplace_back();
+		right_.emplace_back();
+		bottom_.emplace_back();
+		top_.emplace_back();
+	}
+	return instance;
+}
+void AsteroidBatch::removeInstance(const unsigned int instance)
+{
+	const auto index = indices_[instance];
+	const auto last = static_cast<unsigned int>(x_.size() - 1);
+	x_[index] = x_[last];
+	y_[index] = y_[last];
+	halfWidth_[index] = halfWidth_[last];
+	halfHeight_[index] = halfHeight_[last];
+	colors_[index] = colors_[last];
+	handles_[index] = handles_[last];
+	indices_[handles_[index]] = index;
+
+	x_.pop_back();
+	y_.pop_back();
+	halfWidth_.pop_back();
+	halfHeight_.pop_back();
+	colors_.pop_back();
+	handles_.pop_back();
+	freeHandles_.push_back(instance);
+}
+
+// Build quads of instances in the view and submit them
+void AsteroidBatch::draw(Renderer* renderer, const Mat4& transform, const uint32_t flags)
+{
+	const auto count = getInstanceCount();
+	if (count == 0 || !texture_)
+		return;
+
+	// Asteroids don't rotate, so corners are just position -/+ half size
+	const auto* x = x_.data();
+	const auto* y = y_.data();
+	const auto* halfWidth = halfWidth_.data();
+	const auto* halfHeight = halfHeight_.data();
+	auto* left = left_.data();
+	auto* right = right_.data();
+	auto* bottom = bottom_.data();
+	auto* top = top_.data();
+	for (unsigned int i = 0; i < count; ++i)
+		left[i] = x[i] - halfWidth[i];
+	for (unsigned int i = 0; i < count; ++i)
+		right[i] = x[i] + halfWidth[i];
+	for (unsigned int i = 0; i < count; ++i)
+		bottom[i] = y[i] - halfHeight[i];
+	for (unsigned int i = 0; i < count; ++i)
+		top[i] = y[i] + halfHeight[i];
+
+	// Quads of instances in the view are packed to the front
+	const auto& view = transformSync_->getViewRect();
+	const auto viewLeft = view.getMinX();
+	const auto viewRight = view.getMaxX();
+	const auto viewBottom = view.getMinY();
+	const auto viewTop = view.getMaxY();
+	const auto* colors = colors_.data();
+	auto* quads = quads_.data();
+	unsigned int visibleCount = 0;
+	for (unsigned int i = 0; i < count; ++i) {
+		if (right[i] < viewLeft || left[i] > viewRight || top[i] < viewBottom || bottom[i] > viewTop)
+			continue;
+		auto& quad = quads[visibleCount++];
+		quad.bl.vertices = Vec3(left[i], bottom[i], 0);
+		quad.br.vertices = Vec3(right[i], bottom[i], 0);
+		quad.tl.vertices = Vec3(left[i], top[i], 0);
+		quad.tr.vertices = Vec3(right[i], top[i], 0);
+		quad.bl.colors = quad.br.colors = quad.tl.colors = quad.tr.colors = colors[i];
+	}
+
+	if (visibleCount == 0)
+		return;
+	quadCommand_.init(_globalZOrder, texture_, getGLProgramState(), blendFunc_, quads, visibleCount, transform, flags);
+	renderer->addCommand(&quadCommand_);
+}
+
+// Create batch
+AsteroidBatch* AsteroidBatch::create()
+{
+	auto batch = new AsteroidBatch();
+	if (!batch->init()) {
+		delete batch;
+		throw std::invalid_argument("can't create asteroid batch");
+	}
+	batch->autorelease();
+
+	// Asteroid rect in the gameplay atlas, the same way Sprite maps it
+	const auto& sprite = SpriteManifest::get(ASTEROID_SPRITE);
+	batch->texture_ = Director::getInstance()->getTextureCache()->addImage(sprite.texture);
+	if (!batch->texture_)
+		throw std::invalid_argument(std::string("can't load texture ") + sprite.texture);
+	batch->texture_->retain();
+	const auto textureWidth = static_cast<float>(batch->texture_->getPixelsWide());
+	const auto textureHeight = static_cast<float>(batch->texture_->getPixelsHigh());
+	batch->texCoordsMin_ = Tex2F(sprite.x / textureWidth, sprite.y / textureHeight);
+	batch->texCoordsMax_ = Tex2F((sprite.x + sprite.width) / textureWidth, (sprite.y + sprite.height) / textureHeight);
+	batch->size_ = sprite.getSize();
+	batch->blendFunc_ = batch->texture_->hasPremultipliedAlpha() ? BlendFunc::ALPHA_PREMULTIPLIED : BlendFunc::ALPHA_NON_PREMULTIPLIED;
+
+	batch->setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP));
+	return batch;
+}
+
+// Destructor
+AsteroidBatch::~AsteroidBatch()
+{
+	if (texture_)
+		texture_->release();
+}
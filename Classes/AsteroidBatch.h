@@ -0,0 +1,65 @@
+#ifndef __ASTEROID_BATCH_H__
+#define __ASTEROID_BATCH_H__
+
+#include "cocos2d.h"
+#include <vector>
+
+// Forward declarations
+class TransformSync;
+
+// Draws all asteroids of a scene with one quad command, without a node per asteroid
+// Every asteroid is an instance with position, scale and color, stored as structure of arrays
+// Quads are built from the arrays every frame with one simple loop per corner coordinate
+// Instances outside the view of the scene are left out
+// Lives in the scene, one batch per z order
+class AsteroidBatch : public cocos2d::Node
+{
+public:
+	// Return batch of the scene, creates it on first use
+	static AsteroidBatch* getFor(cocos2d::Scene* scene, int zOrder);
+
+	// Add/remove an instance, returns its handle
+	unsigned int addInstance(const cocos2d::Vec2& pos, float scale, const cocos2d::Color3B& color);
+	void removeInstance(unsigned int instance);
+
+	// Change an instance
+	void setInstancePosition(unsigned int instance, const cocos2d::Vec2& pos) { x_[indices_[instance]] = pos.x; y_[indices_[instance]] = pos.y; }
+	void setInstanceColor(unsigned int instance, const cocos2d::Color3B& color) { colors_[indices_[instance]] = cocos2d::Color4B(color); }
+
+	// Return number of instances
+	unsigned int getInstanceCount() const { return static_cast<unsigned int>(x_.size()); }
+
+	// Build quads of instances in the view and submit them
+	virtual void draw(cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t flags) override;
+
+private:
+	// Create batch
+	static AsteroidBatch* create();
+
+private:
+	// Instances, indexed densely, removing one moves the last one in its place
+	std::vector<float> x_, y_;
+	std::vector<float> halfWidth_, halfHeight_; // scaled
+	std::vector<cocos2d::Color4B> colors_;
+	// Dense index by handle and handle by dense index
+	std::vector<unsigned int> indices_;
+	std::vector<unsigned int> handles_;
+	// Removed handles, reused by addInstance
+	std::vector<unsigned int> freeHandles_;
+
+	// Rendering
+	TransformSync* transformSync_ = nullptr; // knows the view
+	cocos2d::Texture2D* texture_ = nullptr;
+	cocos2d::Tex2F texCoordsMin_, texCoordsMax_; // of the asteroid in the atlas, min is top left
+	cocos2d::Size size_; // of the asteroid sprite
+	cocos2d::BlendFunc blendFunc_;
+	std::vector<float> left_, right_, bottom_, top_; // corners of the last frame
+	std::vector<cocos2d::V3F_C4B_T2F_Quad> quads_;
+	cocos2d::QuadCommand quadCommand_;
+
+public:
+	// Destructor
+	virtual ~AsteroidBatch();
+};
+
+#endif // __ASTEROID_BATCH_H__
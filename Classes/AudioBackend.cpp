@@ -0,0 +1,19 @@
+#include "AudioBackend.h"
+
+#include "audio/include/SimpleAudioEngine.h"
+using namespace CocosDenshion;
+
+void SimpleAudioBackend::preloadEffect(const char* file)
+{
+	SimpleAudioEngine::getInstance()->preloadEffect(file);
+}
+
+unsigned int SimpleAudioBackend::playEffect(const char* file)
+{
+	return SimpleAudioEngine::getInstance()->playEffect(file);
+}
+
+void SimpleAudioBackend::stopEffect(const unsigned int id)
+{
+	SimpleAudioEngine::getInstance()->stopEffect(id);
+}
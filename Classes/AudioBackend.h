@@ -0,0 +1,48 @@
+#ifndef __AUDIO_BACKEND_H__
+#define __AUDIO_BACKEND_H__
+
+// Abstract class that plays sound effects for AudioManager
+class AudioBackend
+{
+public:
+	// Load effect before it's played
+	virtual void preloadEffect(const char* file) = 0;
+	// Start effect, returns id of its voice
+	virtual unsigned int playEffect(const char* file) = 0;
+	// Stop voice
+	virtual void stopEffect(unsigned int id) = 0;
+
+	// Important for cleaning memory using base class pointer
+	virtual ~AudioBackend() = default;
+};
+
+// Plays effects with SimpleAudioEngine
+class SimpleAudioBackend : public AudioBackend
+{
+public:
+	virtual void preloadEffect(const char* file) override;
+	virtual unsigned int playEffect(const char* file) override;
+	virtual void stopEffect(unsigned int id) override;
+};
+
+// Plays nothing, only counts calls
+// Used without an audio device and to test AudioManager
+class NullAudioBackend : public AudioBackend
+{
+public:
+	virtual void preloadEffect(const char* file) override { ++preloadCount_; }
+	virtual unsigned int playEffect(const char* file) override { return ++playCount_; }
+	virtual void stopEffect(unsigned int id) override { ++stopCount_; }
+
+	// Return numbers of calls
+	unsigned int getPreloadCount() const { return preloadCount_; }
+	unsigned int getPlayCount() const { return playCount_; }
+	unsigned int getStopCount() const { return stopCount_; }
+
+private:
+	unsigned int preloadCount_ = 0;
+	unsigned int playCount_ = 0;
+	unsigned int stopCount_ = 0;
+};
+
+#endif // __AUDIO_BACKEND_H__
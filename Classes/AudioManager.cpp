@@ -0,0 +1,95 @@
+#include "AudioManager.h"
+#include "Definitions.h"
+#include <cstring>
+#include <stdexcept>
+
+// Return manager of the game, it plays with SimpleAudioBackend
+AudioManager* AudioManager::getInstance()
+{
+	static AudioManager instance(std::make_unique<SimpleAudioBackend>(), AUDIO_MAX_VOICES);
+	return &instance;
+}
+
+// Replace backend, voices of the old one are forgotten
+void AudioManager::setBackend(std::unique_ptr<AudioBackend> backend)
+{
+	if (!backend)
+		throw std::invalid_argument("backend can't be nullptr");
+	backend_ = std::move(backend);
+	voices_.clear();
+}
+
+// Load effect and set its settings
+void AudioManager::preloadEffect(const char* file, const SoundSettings& settings)
+{
+	getSound(file).settings = settings;
+	backend_->preloadEffect(file);
+}
+
+// Play effect, returns false if it was dropped
+bool AudioManager::playEffect(const char* file)
+{
+	auto& sound = getSound(file);
+	const auto& settings = sound.settings;
+
+	// Too soon after the previous one
+	if (sound.lastPlayTime >= 0 && time_ - sound.lastPlayTime < settings.minInterval) {
+		++stats_.rateLimited;
+		return false;
+	}
+
+	// Out of voices, steal the one with the lowest priority, the oldest of them
+	if (voices_.size() >= maxVoices_) {
+		auto victim = voices_.begin();
+		for (auto it = voices_.begin(); it != voices_.end(); ++it)
+			if (it->priority < victim->priority || (it->priority == victim->priority && it->startTime < victim->startTime))
+				victim = it;
+		if (victim->priority > settings.priority) {
+			++stats_.noVoice;
+			return false;
+		}
+		backend_->stopEffect(victim->id);
+		voices_.erase(victim);
+		++stats_.stolen;
+	}
+
+	const auto id = backend_->playEffect(file);
+	voices_.push_back({ id, settings.priority, time_, time_ + settings.length });
+	sound.lastPlayTime = time_;
+	++stats_.played;
+	return true;
+}
+
+// Advance time, finished voices are freed
+void AudioManager::update(const float dT)
+{
+	time_ += dT;
+	for (auto it = voices_.begin(); it != voices_.end();) {
+		if (it->endTime <= time_)
+			it = voices_.erase(it);
+		else
+			++it;
+	}
+}
+
+// Return sound of file, adds it with default settings if it's new
+AudioManager::Sound& AudioManager::getSound(const char* file)
+{
+	if (!file)
+		throw std::invalid_argument("file can't be nullptr");
+
+	for (auto& sound : sounds_)
+		if (std::strcmp(sound.file.c_str(), file) == 0)
+			return sound;
+	sounds_.push_back({ file, AUDIO_DEFAULT_SETTINGS, -1 });
+	return sounds_.back();
+}
+
+// Constructor
+AudioManager::AudioManager(std::unique_ptr<AudioBackend> backend, const unsigned int maxVoices) : maxVoices_(maxVoices)
+{
+	if (maxVoices == 0)
+		throw std::invalid_argument("maxVoices can't be 0");
+	setBackend(std::move(backend));
+	voices_.reserve(maxVoices);
+}
@@ -0,0 +1,91 @@
+#ifndef __AUDIO_MANAGER_H__
+#define __AUDIO_MANAGER_H__
+
+#include "AudioBackend.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// How an effect competes for voices
+struct SoundSettings
+{
+	int priority; // voices of lower priority can be stolen
+	float minInterval; // plays closer than this to the previous one are dropped
+	float length; // voice is busy this long
+};
+
+// Layer between the game and the audio backend
+// At most maxVoices effects play at once, a new effect steals the voice of a lower or equal priority one that started first
+// Effects that are played too often or have no voice to steal are dropped
+class AudioManager
+{
+public:
+	// Return manager of the game, it plays with SimpleAudioBackend
+	static AudioManager* getInstance();
+
+	// Replace backend, voices of the old one are forgotten
+	void setBackend(std::unique_ptr<AudioBackend> backend);
+	AudioBackend* getBackend() const { return backend_.get(); }
+
+	// Load effect and set its settings
+	void preloadEffect(const char* file, const SoundSettings& settings);
+	// Play effect, returns false if it was dropped
+	bool playEffect(const char* file);
+
+	// Advance time, finished voices are freed
+	void update(float dT);
+
+	// Statistics of played and dropped effects
+	struct Stats
+	{
+		uint64_t played = 0;
+		uint64_t rateLimited = 0; // dropped because of minInterval
+		uint64_t noVoice = 0; // dropped because all voices had higher priority
+		uint64_t stolen = 0; // voices stopped to play another effect
+	};
+	const Stats& getStats() const { return stats_; }
+	void resetStats() { stats_ = Stats(); }
+	// Return number of busy voices
+	unsigned int getVoiceCount() const { return static_cast<unsigned int>(voices_.size()); }
+
+	// Constructor
+	AudioManager(std::unique_ptr<AudioBackend> backend, unsigned int maxVoices);
+
+private:
+	// Effect and when it was last played
+	struct Sound
+	{
+		std::string file;
+		SoundSettings settings;
+		double lastPlayTime;
+	};
+	// Playing effect
+	struct Voice
+	{
+		unsigned int id;
+		int priority;
+		double startTime;
+		double endTime;
+	};
+
+	// Return sound of file, adds it with default settings if it's new
+	Sound& getSound(const char* file);
+
+	// Backend
+	std::unique_ptr<AudioBackend> backend_;
+
+	// Known effects, there are few of them
+	std::vector<Sound> sounds_;
+	// Busy voices
+	std::vector<Voice> voices_;
+	unsigned int maxVoices_;
+
+	// Time since creation
+	double time_ = 0;
+
+	// Statistics
+	Stats stats_;
+};
+
+#endif // __AUDIO_MANAGER_H__
@@ -0,0 +1,152 @@
+#include "BurstBatch.h"
+#include "ParticleCache.h"
+#include "Definitions.h"
+#include <cmath>
+
+USING_NS_CC;
+
+// Return batch of the scene for particle file, creates it on first use
+BurstBatch* BurstBatch::getFor(Scene* scene, const std::string& file, const int zOrder)
+{
+	if (!scene)
+		throw std::invalid_argument("scene can't be nullptr");
+
+	const auto name = file + "#" + std::to_string(zOrder);
+	auto batch = dynamic_cast<BurstBatch*>(scene->getChildByName(name));
+	if (!batch) {
+		batch = BurstBatch::create(file);
+		batch->setName(name);
+		scene->addChild(batch, zOrder);
+	}
+	return batch;
+}
+
+// Update particles
+void BurstBatch::update(const float dT)
+{
+	particles_->update(dT);
+}
+
+// Build quads of all particles and submit them
+void BurstBatch::draw(Renderer* renderer, const Mat4& transform, const uint32_t flags)
+{
+	const auto count = particles_->getParticleCount();
+	if (count == 0 || !texture_)
+		return;
+
+	const auto* originX = particles_->getOriginX();
+	const auto* originY = particles_->getOriginY();
+	const auto* offsetX = particles_->getOffsetX();
+	const auto* offsetY = particles_->getOffsetY();
+	const auto* scale = particles_->getScale();
+	const auto* size = particles_->getSize();
+	const auto* rotation = particles_->getRotation();
+	const auto* colorR = particles_->getColorR();
+	const auto* colorG = particles_->getColorG();
+	const auto* colorB = particles_->getColorB();
+	const auto* colorA = particles_->getColorA();
+	for (unsigned int i = 0; i < count; ++i) {
+		// Same corners as ParticleSystemQuad, scaled around burst position
+		const auto x = originX[i] + offsetX[i] * scale[i];
+		const auto y = originY[i] + offsetY[i] * scale[i];
+		const auto halfSize = size[i] * scale[i] / 2;
+		const auto angle = -CC_DEGREES_TO_RADIANS(rotation[i]);
+		const auto cosHalf = std::cos(angle) * halfSize;
+		const auto sinHalf = std::sin(angle) * halfSize;
+
+		auto& quad = quads_[i];
+		quad.bl.vertices = Vec3(x - cosHalf + sinHalf, y - sinHalf - cosHalf, 0);
+		quad.br.vertices = Vec3(x + cosHalf + sinHalf, y + sinHalf - cosHalf, 0);
+		quad.tr.vertices = Vec3(x + cosHalf - sinHalf, y + sinHalf + cosHalf, 0);
+		quad.tl.vertices = Vec3(x - cosHalf - sinHalf, y - sinHalf + cosHalf, 0);
+
+		const auto a = clampf(colorA[i], 0, 1);
+		const auto k = opacityModifyRGB_ ? a : 1.0f;
+		const Color4B color(static_cast<GLubyte>(clampf(colorR[i], 0, 1) * k * 255), static_cast<GLubyte>(clampf(colorG[i], 0, 1) * k * 255),
+			static_cast<GLubyte>(clampf(colorB[i], 0, 1) * k * 255), static_cast<GLubyte>(a * 255));
+		quad.bl.colors = quad.br.colors = quad.tr.colors = quad.tl.colors = color;
+	}
+
+	quadCommand_.init(_globalZOrder, texture_, getGLProgramState(), blendFunc_, quads_.data(), count, transform, flags);
+	renderer->addCommand(&quadCommand_);
+}
+
+// Create from particle file
+BurstBatch* BurstBatch::create(const std::string& file)
+{
+	auto batch = new BurstBatch();
+	if (!batch->init()) {
+		delete batch;
+		throw std::invalid_argument("can't create burst batch");
+	}
+	batch->autorelease();
+
+	// Particle system is only read and thrown away
+	auto system = ParticleCache::getInstance()->create(file);
+	if (!system)
+		throw std::invalid_argument("can't create particles from " + file);
+	batch->particles_ = std::make_unique<BurstParticles>(getParams(system), BURST_MAX_PARTICLES);
+	batch->texture_ = system->getTexture();
+	if (batch->texture_)
+		batch->texture_->retain();
+	batch->blendFunc_ = system->getBlendFunc();
+	batch->opacityModifyRGB_ = system->isOpacityModifyRGB();
+
+	// Texture coordinates never change
+	batch->quads_.resize(BURST_MAX_PARTICLES);
+	for (auto& quad : batch->quads_) {
+		quad.bl.texCoords = Tex2F(0, 1);
+		quad.br.texCoords = Tex2F(1, 1);
+		quad.tl.texCoords = Tex2F(0, 0);
+		quad.tr.texCoords = Tex2F(1, 0);
+	}
+
+	batch->setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP));
+	batch->scheduleUpdate();
+	return batch;
+}
+
+// Read parameters of a particle system
+BurstParams BurstBatch::getParams(const ParticleSystem* system)
+{
+	if (system->getEmitterMode() != ParticleSystem::Mode::GRAVITY)
+		throw std::invalid_argument("only gravity mode particles can be bursts");
+
+	BurstParams params;
+	params.duration = system->getDuration();
+	params.emissionRate = system->getEmissionRate();
+	params.totalParticles = system->getTotalParticles();
+	params.life = system->getLife();
+	params.lifeVar = system->getLifeVar();
+	params.angle = system->getAngle();
+	params.angleVar = system->getAngleVar();
+	params.speed = system->getSpeed();
+	params.speedVar = system->getSpeedVar();
+	params.gravity = system->getGravity();
+	params.radialAccel = system->getRadialAccel();
+	params.radialAccelVar = system->getRadialAccelVar();
+	params.tangentialAccel = system->getTangentialAccel();
+	params.tangentialAccelVar = system->getTangentialAccelVar();
+	params.posVar = system->getPosVar();
+	params.startSize = system->getStartSize();
+	params.startSizeVar = system->getStartSizeVar();
+	params.endSize = system->getEndSize(); // ParticleSystem::START_SIZE_EQUAL_TO_END_SIZE is -1
+	params.endSizeVar = system->getEndSizeVar();
+	params.startColor = system->getStartColor();
+	params.startColorVar = system->getStartColorVar();
+	params.endColor = system->getEndColor();
+	params.endColorVar = system->getEndColorVar();
+	params.startSpin = system->getStartSpin();
+	params.startSpinVar = system->getStartSpinVar();
+	params.endSpin = system->getEndSpin();
+	params.endSpinVar = system->getEndSpinVar();
+	params.rotationIsDir = system->getRotationIsDir();
+	return params;
+}
+
+// Destructor
+BurstBatch::~BurstBatch()
+{
+	if (texture_)
+		texture_->release();
+}
@@ -0,0 +1,51 @@
+#ifndef __BURST_BATCH_H__
+#define __BURST_BATCH_H__
+
+#include "cocos2d.h"
+#include "BurstParticles.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Draws all bursts of one particle effect (sparks, debris, wrecks) of a scene with one quad command
+// Particles are simulated by BurstParticles, parameters, texture and blending come from a plist
+// Lives in the scene, one batch per particle file and z order
+class BurstBatch : public cocos2d::Node
+{
+public:
+	// Return batch of the scene for particle file, creates it on first use
+	static BurstBatch* getFor(cocos2d::Scene* scene, const std::string& file, int zOrder);
+
+	// Start a burst at position
+	// Scale multiplies sizes and distances from position, tint multiplies colors
+	void addBurst(const cocos2d::Vec2& pos, float scale = 1, const cocos2d::Color3B& tint = cocos2d::Color3B::WHITE) { particles_->addBurst(pos, scale, tint); }
+	void addBurst(const cocos2d::Vec2& pos, const cocos2d::Color4F& startColor, float scale = 1, const cocos2d::Color3B& tint = cocos2d::Color3B::WHITE) { particles_->addBurst(pos, startColor, scale, tint); }
+
+	// Update particles
+	virtual void update(float dT) override;
+	// Build quads of all particles and submit them
+	virtual void draw(cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t flags) override;
+
+private:
+	// Create from particle file
+	static BurstBatch* create(const std::string& file);
+	// Read parameters of a particle system
+	static BurstParams getParams(const cocos2d::ParticleSystem* system);
+
+private:
+	// Particles of all bursts
+	std::unique_ptr<BurstParticles> particles_;
+
+	// Rendering
+	cocos2d::Texture2D* texture_ = nullptr;
+	cocos2d::BlendFunc blendFunc_;
+	bool opacityModifyRGB_ = false;
+	std::vector<cocos2d::V3F_C4B_T2F_Quad> quads_;
+	cocos2d::QuadCommand quadCommand_;
+
+public:
+	// Destructor
+	virtual ~BurstBatch();
+};
+
+#endif // __BURST_BATCH_H__
@@ -0,0 +1,221 @@
+#include "BurstParticles.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+USING_NS_CC;
+
+// Start a burst at position
+// Scale multiplies sizes and distances from position, tint multiplies colors
+void BurstParticles::addBurst(const Vec2& pos, const Color4F& startColor, const float scale, const Color3B& tint)
+{
+	bursts_.push_back({ pos, startColor, scale, tint, 0, 0, 0 });
+}
+
+// Emit particles of running bursts, then move, color, resize and age all particles
+void BurstParticles::update(const float dT)
+{
+	// Emit the same way a ParticleSystem does, each burst is one emitter
+	if (params_.emissionRate > 0) {
+		const auto rate = 1.0f / params_.emissionRate;
+		for (auto& burst : bursts_) {
+			burst.emitCounter += dT;
+			const auto wanted = static_cast<unsigned int>(burst.emitCounter / rate);
+			const auto count = std::min({ wanted, params_.totalParticles - burst.emitted, maxParticles_ - count_ });
+			emit(burst, count);
+			burst.emitted += count;
+			burst.emitCounter -= rate * count;
+			burst.elapsed += dT;
+		}
+	}
+	// Remove finished bursts
+	const auto duration = params_.duration;
+	const auto totalParticles = params_.totalParticles;
+	bursts_.erase(std::remove_if(bursts_.begin(), bursts_.end(), [duration, totalParticles](const Burst& burst) {
+		return (duration >= 0 && burst.elapsed > duration) || burst.emitted >= totalParticles;
+	}), bursts_.end());
+
+	// Age
+	const auto count = count_;
+	auto* timeToLive = timeToLive_.data();
+	for (unsigned int i = 0; i < count; ++i)
+		timeToLive[i] -= dT;
+	removeDead();
+
+	// Accelerate and move, offsets are relative to burst position
+	const auto n = count_;
+	auto* offsetX = offsetX_.data();
+	auto* offsetY = offsetY_.data();
+	auto* speedX = speedX_.data();
+	auto* speedY = speedY_.data();
+	const auto* radialAccel = radialAccel_.data();
+	const auto* tangentialAccel = tangentialAccel_.data();
+	const auto gravityX = params_.gravity.x;
+	const auto gravityY = params_.gravity.y;
+	if (hasRadialAccel_) {
+		for (unsigned int i = 0; i < n; ++i) {
+			const auto inverseLength = 1 / std::sqrt(std::max(offsetX[i] * offsetX[i] + offsetY[i] * offsetY[i], FLT_MIN)); // offset 0 gives radial 0
+			const auto radialX = offsetX[i] * inverseLength;
+			const auto radialY = offsetY[i] * inverseLength;
+			speedX[i] += (radialX * radialAccel[i] - radialY * tangentialAccel[i]) * dT;
+			speedY[i] += (radialY * radialAccel[i] + radialX * tangentialAccel[i]) * dT;
+		}
+	}
+	for (unsigned int i = 0; i < n; ++i)
+		speedX[i] += gravityX * dT;
+	for (unsigned int i = 0; i < n; ++i)
+		speedY[i] += gravityY * dT;
+	for (unsigned int i = 0; i < n; ++i)
+		offsetX[i] += speedX[i] * dT;
+	for (unsigned int i = 0; i < n; ++i)
+		offsetY[i] += speedY[i] * dT;
+
+	// Color
+	auto* colorR = colorR_.data();
+	auto* colorG = colorG_.data();
+	auto* colorB = colorB_.data();
+	auto* colorA = colorA_.data();
+	const auto* deltaR = deltaR_.data();
+	const auto* deltaG = deltaG_.data();
+	const auto* deltaB = deltaB_.data();
+	const auto* deltaA = deltaA_.data();
+	for (unsigned int i = 0; i < n; ++i)
+		colorR[i] += deltaR[i] * dT;
+	for (unsigned int i = 0; i < n; ++i)
+		colorG[i] += deltaG[i] * dT;
+	for (unsigned int i = 0; i < n; ++i)
+		colorB[i] += deltaB[i] * dT;
+	for (unsigned int i = 0; i < n; ++i)
+		colorA[i] += deltaA[i] * dT;
+
+	// Size and rotation
+	auto* size = size_.data();
+	auto* rotation = rotation_.data();
+	const auto* deltaSize = deltaSize_.data();
+	const auto* deltaRotation = deltaRotation_.data();
+	for (unsigned int i = 0; i < n; ++i)
+		size[i] = std::max(0.0f, size[i] + deltaSize[i] * dT);
+	for (unsigned int i = 0; i < n; ++i)
+		rotation[i] += deltaRotation[i] * dT;
+}
+
+// Add particles of a burst
+void BurstParticles::emit(const Burst& burst, const unsigned int count)
+{
+	const auto& p = params_;
+	const auto tintR = burst.tint.r / 255.0f;
+	const auto tintG = burst.tint.g / 255.0f;
+	const auto tintB = burst.tint.b / 255.0f;
+	for (unsigned int k = 0; k < count; ++k) {
+		const auto i = count_++;
+
+		// Life
+		const auto life = std::max(0.0f, p.life + p.lifeVar * random_.next_minus1_1());
+		timeToLive_[i] = life;
+
+		// Position
+		originX_[i] = burst.pos.x;
+		originY_[i] = burst.pos.y;
+		offsetX_[i] = p.posVar.x * random_.next_minus1_1();
+		offsetY_[i] = p.posVar.y * random_.next_minus1_1();
+		scale_[i] = burst.scale;
+
+		// Color
+		const auto startR = clampf(burst.startColor.r + p.startColorVar.r * random_.next_minus1_1(), 0, 1);
+		const auto startG = clampf(burst.startColor.g + p.startColorVar.g * random_.next_minus1_1(), 0, 1);
+		const auto startB = clampf(burst.startColor.b + p.startColorVar.b * random_.next_minus1_1(), 0, 1);
+		const auto startA = clampf(burst.startColor.a + p.startColorVar.a * random_.next_minus1_1(), 0, 1);
+		const auto endR = clampf(p.endColor.r + p.endColorVar.r * random_.next_minus1_1(), 0, 1);
+		const auto endG = clampf(p.endColor.g + p.endColorVar.g * random_.next_minus1_1(), 0, 1);
+		const auto endB = clampf(p.endColor.b + p.endColorVar.b * random_.next_minus1_1(), 0, 1);
+		const auto endA = clampf(p.endColor.a + p.endColorVar.a * random_.next_minus1_1(), 0, 1);
+		const auto inverseLife = life > 0 ? 1 / life : 0.0f;
+		colorR_[i] = startR * tintR;
+		colorG_[i] = startG * tintG;
+		colorB_[i] = startB * tintB;
+		colorA_[i] = startA;
+		deltaR_[i] = (endR - startR) * tintR * inverseLife;
+		deltaG_[i] = (endG - startG) * tintG * inverseLife;
+		deltaB_[i] = (endB - startB) * tintB * inverseLife;
+		deltaA_[i] = (endA - startA) * inverseLife;
+
+		// Size
+		const auto startSize = std::max(0.0f, p.startSize + p.startSizeVar * random_.next_minus1_1());
+		size_[i] = startSize;
+		if (p.endSize < 0)
+			deltaSize_[i] = 0;
+		else
+			deltaSize_[i] = (std::max(0.0f, p.endSize + p.endSizeVar * random_.next_minus1_1()) - startSize) * inverseLife;
+
+		// Rotation
+		const auto startSpin = p.startSpin + p.startSpinVar * random_.next_minus1_1();
+		const auto endSpin = p.endSpin + p.endSpinVar * random_.next_minus1_1();
+		rotation_[i] = startSpin;
+		deltaRotation_[i] = (endSpin - startSpin) * inverseLife;
+
+		// Direction and accelerations
+		const auto angle = CC_DEGREES_TO_RADIANS(p.angle + p.angleVar * random_.next_minus1_1());
+		const auto speed = p.speed + p.speedVar * random_.next_minus1_1();
+		speedX_[i] = std::cos(angle) * speed;
+		speedY_[i] = std::sin(angle) * speed;
+		radialAccel_[i] = p.radialAccel + p.radialAccelVar * random_.next_minus1_1();
+		tangentialAccel_[i] = p.tangentialAccel + p.tangentialAccelVar * random_.next_minus1_1();
+		if (p.rotationIsDir)
+			rotation_[i] = -CC_RADIANS_TO_DEGREES(std::atan2(speedY_[i], speedX_[i]));
+	}
+}
+
+// Remove dead particles by moving the last ones in their place
+void BurstParticles::removeDead()
+{
+	unsigned int i = 0;
+	while (i < count_) {
+		if (timeToLive_[i] > 0) {
+			++i;
+			continue;
+		}
+
+		const auto last = --count_;
+		if (i == last)
+			break;
+		originX_[i] = originX_[last];
+		originY_[i] = originY_[last];
+		offsetX_[i] = offsetX_[last];
+		offsetY_[i] = offsetY_[last];
+		speedX_[i] = speedX_[last];
+		speedY_[i] = speedY_[last];
+		radialAccel_[i] = radialAccel_[last];
+		tangentialAccel_[i] = tangentialAccel_[last];
+		scale_[i] = scale_[last];
+		size_[i] = size_[last];
+		deltaSize_[i] = deltaSize_[last];
+		rotation_[i] = rotation_[last];
+		deltaRotation_[i] = deltaRotation_[last];
+		colorR_[i] = colorR_[last];
+		colorG_[i] = colorG_[last];
+		colorB_[i] = colorB_[last];
+		colorA_[i] = colorA_[last];
+		deltaR_[i] = deltaR_[last];
+		deltaG_[i] = deltaG_[last];
+		deltaB_[i] = deltaB_[last];
+		deltaA_[i] = deltaA_[last];
+		timeToLive_[i] = timeToLive_[last];
+	}
+}
+
+// Constructor
+// At most maxParticles are alive at once, further particles are not emitted
+BurstParticles::BurstParticles(const BurstParams& params, const unsigned int maxParticles, const uint64_t seed) : params_(params), maxParticles_(maxParticles)
+{
+	if (maxParticles == 0)
+		throw std::invalid_argument("maxParticles can't be 0");
+
+	// Arrays never grow, so update never allocates
+	for (auto attribute : { &originX_, &originY_, &offsetX_, &offsetY_, &speedX_, &speedY_, &radialAccel_, &tangentialAccel_, &scale_, &size_, &deltaSize_,
+		&rotation_, &deltaRotation_, &colorR_, &colorG_, &colorB_, &colorA_, &deltaR_, &deltaG_, &deltaB_, &deltaA_, &timeToLive_ })
+		attribute->resize(maxParticles);
+	bursts_.reserve(maxParticles / std::max(1u, params.totalParticles) + 1);
+
+	hasRadialAccel_ = params.radialAccel != 0 || params.radialAccelVar != 0 || params.tangentialAccel != 0 || params.tangentialAccelVar != 0;
+	random_.setSeed(seed);
+}
@@ -0,0 +1,117 @@
+#ifndef __BURST_PARTICLES_H__
+#define __BURST_PARTICLES_H__
+
+#include "cocos2d.h" // Just for basic things like Vec2 and colors
+#include "Physics/PhysRandom.h"
+#include <vector>
+
+// Parameters of a burst effect, same meaning as in particle plists (gravity mode only)
+// Angles are in degrees, times in seconds
+struct BurstParams
+{
+	float duration = 0; // of emission
+	float emissionRate = 0; // particles per second
+	unsigned int totalParticles = 0; // most particles one burst emits
+
+	float life = 0, lifeVar = 0;
+	float angle = 0, angleVar = 0;
+	float speed = 0, speedVar = 0;
+	cocos2d::Vec2 gravity;
+	float radialAccel = 0, radialAccelVar = 0;
+	float tangentialAccel = 0, tangentialAccelVar = 0;
+	cocos2d::Vec2 posVar;
+
+	float startSize = 0, startSizeVar = 0;
+	float endSize = 0, endSizeVar = 0; // endSize < 0 means the same as start size
+	cocos2d::Color4F startColor, startColorVar;
+	cocos2d::Color4F endColor, endColorVar;
+	float startSpin = 0, startSpinVar = 0;
+	float endSpin = 0, endSpinVar = 0;
+	bool rotationIsDir = false;
+};
+
+// CPU side of short one-shot particle effects (sparks, debris, wrecks)
+// Particles of all bursts of one effect are stored together as structure of arrays
+// Update runs one simple loop per attribute over all particles, so compilers can vectorize them
+// Doesn't touch the GPU, rendering is done by BurstBatch
+class BurstParticles
+{
+public:
+	// Start a burst at position
+	// Scale multiplies sizes and distances from position, tint multiplies colors
+	void addBurst(const cocos2d::Vec2& pos, const cocos2d::Color4F& startColor, float scale = 1, const cocos2d::Color3B& tint = cocos2d::Color3B::WHITE);
+	void addBurst(const cocos2d::Vec2& pos, float scale = 1, const cocos2d::Color3B& tint = cocos2d::Color3B::WHITE) { addBurst(pos, params_.startColor, scale, tint); }
+
+	// Emit particles of running bursts, then move, color, resize and age all particles
+	void update(float dT);
+
+	// Return parameters
+	const BurstParams& getParams() const { return params_; }
+	// Return number of live particles and bursts that are still emitting
+	unsigned int getParticleCount() const { return count_; }
+	unsigned int getBurstCount() const { return static_cast<unsigned int>(bursts_.size()); }
+
+	// Particle attributes, valid for indices below getParticleCount()
+	// Position on screen is origin + offset * scale
+	const float* getOriginX() const { return originX_.data(); }
+	const float* getOriginY() const { return originY_.data(); }
+	const float* getOffsetX() const { return offsetX_.data(); }
+	const float* getOffsetY() const { return offsetY_.data(); }
+	const float* getScale() const { return scale_.data(); }
+	const float* getSize() const { return size_.data(); }
+	const float* getRotation() const { return rotation_.data(); }
+	const float* getColorR() const { return colorR_.data(); }
+	const float* getColorG() const { return colorG_.data(); }
+	const float* getColorB() const { return colorB_.data(); }
+	const float* getColorA() const { return colorA_.data(); }
+
+	// Constructor
+	// At most maxParticles are alive at once, further particles are not emitted
+	BurstParticles(const BurstParams& params, unsigned int maxParticles, uint64_t seed = 0);
+
+private:
+	// One burst that is still emitting
+	struct Burst
+	{
+		cocos2d::Vec2 pos;
+		cocos2d::Color4F startColor;
+		float scale;
+		cocos2d::Color3B tint;
+		float elapsed;
+		float emitCounter;
+		unsigned int emitted;
+	};
+
+	// Add particles of a burst
+	void emit(const Burst& burst, unsigned int count);
+	// Remove dead particles by moving the last ones in their place
+	void removeDead();
+
+	// Parameters of the effect
+	BurstParams params_;
+	// Radial and tangential accelerations need distances from burst position, most effects don't have them
+	bool hasRadialAccel_;
+	// Running bursts
+	std::vector<Burst> bursts_;
+
+	// Live particles and capacity of arrays
+	unsigned int count_ = 0;
+	unsigned int maxParticles_;
+
+	// Particle attributes
+	std::vector<float> originX_, originY_;
+	std::vector<float> offsetX_, offsetY_;
+	std::vector<float> speedX_, speedY_;
+	std::vector<float> radialAccel_, tangentialAccel_;
+	std::vector<float> scale_;
+	std::vector<float> size_, deltaSize_;
+	std::vector<float> rotation_, deltaRotation_;
+	std::vector<float> colorR_, colorG_, colorB_, colorA_;
+	std::vector<float> deltaR_, deltaG_, deltaB_, deltaA_;
+	std::vector<float> timeToLive_;
+
+	// Random numbers of variances
+	PhysRandom random_;
+};
+
+#endif // __BURST_PARTICLES_H__
@@ -23,6 +23,8 @@
 #define GAME_OVER_NUMBER_MAX_DELAY 0.55
 #define GAME_OVER_NUMBER_TICK_POWER 1.3
 #define GAME_UI_SCALE 0.8
+#define PROFILER_HUD_FONT_SIZE (0.02 * V_SIZE.height)
+#define PROFILER_HUD_UPDATE_STEPS 15 // text is updated only every few steps
 
 // For memory
 #define BEST_SCORE_TAG "BestScore"
@@ -46,6 +48,7 @@
 #define ASTEROID_SPRITE "sprites/Asteroid.png"
 #define WIN_SPRITE "sprites/WinLabel.png"
 #define LOSS_SPRITE "sprites/LossLabel.png"
+#define GAMEPLAY_ATLAS "atlases/Gameplay.png" // made from gunship, gun, laser ball and asteroid sprites by manifest_generator
 
 // For sounds
 #define GAME_BACKGROUND_MUSIC "audio/bgGame.mp3"
@@ -62,6 +65,20 @@
 #define TIME_TICK_SOUND_EFFECT "audio/timeTick.wav"
 #define WIN_SOUND_EFFECT "audio/win.wav"
 
+// For sound voices
+// Settings are { priority, min interval between plays, length }, higher priority steals voices of lower
+#define AUDIO_MAX_VOICES 8
+#define AUDIO_DEFAULT_SETTINGS { 0, 0.0f, 0.5f }
+#define CLICK_SOUND_SETTINGS { 3, 0.0f, 0.14f }
+#define LASER_HIT_SOUND_SETTINGS { 1, 0.03f, 0.35f }
+#define LASER_BOUNCE_SOUND_SETTINGS { 0, 0.05f, 0.12f }
+#define SHOOT_NORMAL_SOUND_SETTINGS { 1, 0.0f, 0.69f }
+#define SHOOT_POWERFUL_SOUND_SETTINGS { 2, 0.0f, 1.57f }
+#define SCORE_TICK_SOUND_SETTINGS { 2, 0.0f, 0.06f }
+#define TIME_OUT_SOUND_SETTINGS { 4, 0.0f, 2.0f }
+#define TIME_TICK_SOUND_SETTINGS { 3, 0.0f, 0.09f }
+#define WIN_SOUND_SETTINGS { 4, 0.0f, 2.62f }
+
 // For particles
 #define STARS_PARTICLES "particles/stars.plist"
 #define SPARKS_PARTICLES "particles/spark.plist"
@@ -73,13 +90,42 @@
 #define ASTEROID_BREAK_PARTICLES "particles/wreck.plist"
 #define ASTEROID_BOUNCED_PARTICLES "particles/debris.plist"
 #define CURSOR_PARTICLES "particles/cursor.plist"
+#define BURST_MAX_PARTICLES 4096 // live particles of one burst effect batch, more are not emitted
+
+// For merging hit effects of the same frame
+#define EFFECT_MERGE_RADIUS 24.0f // same effects closer than this are merged
+#define EFFECT_MERGE_TIME 0.05f // same effects closer than EFFECT_MERGE_RADIUS to one emitted this long ago are dropped
+#define EFFECT_MERGE_SCALE_STEP 0.25f // burst scale added by every merged request
+#define EFFECT_MERGE_MAX_SCALE 2.0f
+#define EFFECT_MAX_BURSTS 8 // per flush
+#define EFFECT_MAX_SOUNDS 4 // per flush
+#define EFFECT_QUEUE_NAME "EffectQueue"
+#define TRANSFORM_SYNC_NAME "TransformSync"
+#define CULLING_MARGIN 160 // nodes this far outside the screen are still drawn, more than half of the largest scaled sprite
 
 // For scene transitions and durations
 #define SCENE_TRANSITION_TIME 0.5
 #define SCENE_TRANSITION_TYPE TransitionCrossFade
 #define SCENE_TRANSITION(scene) SCENE_TRANSITION_TYPE::create(SCENE_TRANSITION_TIME, scene)
 #define GAME_OVER_SCENE_TRANSITION_DELAY 0.8 // delay after game is over and before going to game over screen
-#define SPLASH_SCREEN_DURATION 1.0
+#define SPLASH_SCREEN_DURATION 1.0 // at least, splash screen also waits for assets
+
+// For asset preloading during the splash screen
+#define ASSET_PRELOADER_MAX_THREADS 3
+#define ASSET_PRELOADER_STEPS_PER_FRAME 4 // uploads and main thread tasks
+#define FONT_PRELOAD_GLYPHS u" %/:0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+#define SPLASH_PROGRESS_BAR_WIDTH (0.3 * V_SIZE.width)
+#define SPLASH_PROGRESS_BAR_HEIGHT (0.01 * V_SIZE.height)
+#define SPLASH_PROGRESS_BAR_Y (ORIGIN.y + 0.1 * V_SIZE.height)
+#define SPLASH_PROGRESS_BAR_COLOR Color4F(1, 1, 1, 0.8f)
+
+// For the packed asset archive, made from Resources by asset_packer
+#define ASSET_ARCHIVE_FILE "assets.pak" // in resources, files not in it are read as usual, CMakeLists.txt reads the name from here
+#define ASSET_ARCHIVE_MAGIC "GPAK"
+#define ASSET_ARCHIVE_VERSION 1
+#define ASSET_ARCHIVE_ALIGNMENT 64 // of file data
+#define ASSET_ARCHIVE_MIN_SAVING 0.1 // compressed files have to be this much smaller, others are stored
+#define ASSET_ARCHIVE_SKIPPED_EXTENSIONS { ".wav", ".mp3", ".ogg" } // audio engines open sounds by path
 
 // Z levels
 #define Z_LEVEL_BACKGROUND	0
@@ -97,10 +143,12 @@
 #define POWER_SHOT_CURVE_DURATION 0.5
 #define GUNSHIP_MASS 3.5
 #define GUNSHIP_BOUNCINESS 1
-#define GUNSHIP_ACCELERATION (0.1 * V_SIZE.width)
+#define GUNSHIP_ACCELERATION 0.1 // based on screen width
 #define LASER_BALL_MASS 0.8
 #define LASER_BALL_BOUNCINESS 1
 #define LASER_BALL_LIFE_TIME 5
+#define LASER_BALLS_PREWARM 14 // enough for all laser balls alive at once (LASER_BALL_LIFE_TIME / SHOT_INTERVAL + 1)
+#define LASER_BALL_TRAIL_MAX_EMITTERS 16 // particles of this many tails fit into the shared trail batch
 #define LASER_BALL_SPAWN_DISTANCE 0.8 // based on cannon size
 #define LASER_BALL_NORMAL_COLOR Color3B::WHITE
 #define LASER_BALL_POWERFUL_COLOR Color3B(40, 210, 35)
@@ -121,8 +169,18 @@
 
 // For physics
 #define PHYSICS_UPDATE_INTERVAL (1.0 / 60)
-#define N_PARTITIONS_X 4
+#define PHYSICS_MAX_STEPS_PER_FRAME 4 // more steps of a long frame are dropped, so that a slow frame doesn't make the next ones slower
+#define PHYSICS_INTERPOLATION 1 // draw bodies between their last two steps, 0 draws the last step (one step less latency, stutters on high refresh rates)
+#define PHYS_LOD_FOCUS_MARGIN 0.1 // based on screen size, bodies this close to the screen or the gunship step every step, covers the whole one screen world
+#define PHYS_LOD_TIER_DISTANCE 0.5 // based on focus width, every this much further from the focus bodies step half as often
+#define PHYS_LOD_MAX_TIER 3 // farthest bodies step once in 2^3 steps
+#define N_PARTITIONS_X 4 // at least, larger worlds have more
 #define N_PARTITIONS_Y 3
+#define PARTITION_MAX_SIZE Size(640, 480) // grid gets finer when partitions would be larger, a one screen world keeps 4x3
+#define PHYS_FRAME_ARENA_SIZE 65536 // bytes for temporaries of one step, grows if a step needs more
+#define PHYS_EVALUATION_CAPACITY 1024 // bodies queued for evaluation in one step, grows if more are queued
+#define PHYS_CONTACTS_CAPACITY 1024 // contacts at once without growing buckets of the contact set
+#define PHYS_PARTITION_CAPACITY 128 // bodies in one partition without growing its buckets
 #define PARTITIONS_OUTSIDE_OFFSET 0.05 // based on screen size
 #define DIR_HELPER 0.9
 #define EDGE_WIDTH 10
@@ -152,6 +210,14 @@
 #define INPUT_COUNT_TARGET_TAG "CountTarget"
 #define INPUT_PROJECTILE_SPEED_TAG "Speed"
 #define INPUT_GAME_TIME_TAG "Time"
+#define INPUT_SEED_TAG "Seed"
+#define INPUT_ASTEROID_MAX_SPEED_TAG "AsteroidMaxSpeed"
+#define INPUT_ASTEROID_MIN_SCALE_TAG "AsteroidMinScale"
+#define INPUT_ASTEROID_MAX_SCALE_TAG "AsteroidMaxScale"
+#define RECORDING_FILE "lastGame.rec" // every game is recorded to writable path
+#define REPLAY_FILE "replay.rec" // if found in resources, it is replayed instead of a new game
+#define TRACE_FILE "trace.json" // written to writable path on exit and with F4 in game
+#define ALLOCATION_FRAME_BUDGET 64 // frames with more allocations are logged (if allocation tracking is enabled)
 
 
 #endif // __DEFINITIONS_H__
@@ -0,0 +1,144 @@
+#include "EffectQueue.h"
+#include "BurstBatch.h"
+#include "AudioManager.h"
+#include "Definitions.h"
+#include "Trace.h"
+#include "AllocationTracker.h"
+#include <algorithm>
+#include <cstring>
+
+USING_NS_CC;
+
+// Return queue of the scene, creates it on first use
+EffectQueue* EffectQueue::getFor(Scene* scene)
+{
+	if (!scene)
+		throw std::invalid_argument("scene can't be nullptr");
+
+	auto queue = dynamic_cast<EffectQueue*>(scene->getChildByName(EFFECT_QUEUE_NAME));
+	if (!queue) {
+		queue = EffectQueue::create();
+		queue->setName(EFFECT_QUEUE_NAME);
+		queue->scene_ = scene;
+		scene->addChild(queue);
+	}
+	return queue;
+}
+
+// Request a burst of particle file at position, it's drawn by the BurstBatch of file and zOrder
+// File name is kept until flush, so it should be a literal
+void EffectQueue::addBurst(const char* file, const int zOrder, const Vec2& pos, const float scale, const Color3B& tint)
+{
+	requests_.push_back({ false, file, zOrder, pos, false, Color4F::WHITE, scale, tint, 1 });
+}
+void EffectQueue::addBurst(const char* file, const int zOrder, const Vec2& pos, const Color4F& startColor, const float scale, const Color3B& tint)
+{
+	requests_.push_back({ false, file, zOrder, pos, true, startColor, scale, tint, 1 });
+}
+// Request a sound effect that happened at position
+void EffectQueue::addSound(const char* file, const Vec2& pos)
+{
+	requests_.push_back({ true, file, 0, pos, false, Color4F::WHITE, 1, Color3B::WHITE, 1 });
+}
+
+// Merge requests and emit merged effects, dT is time since the last flush
+void EffectQueue::flush(const float dT)
+{
+	TRACE_SCOPE("EffectQueue::flush");
+	ALLOCATION_SCOPE("Particles");
+
+	// Forget old effects
+	for (auto& recent : recent_)
+		recent.time += dT;
+	recent_.erase(std::remove_if(recent_.begin(), recent_.end(), [](const Recent& recent) { return recent.time > EFFECT_MERGE_TIME; }), recent_.end());
+
+	lastRequestCount_ = static_cast<unsigned int>(requests_.size());
+	lastEmittedCount_ = 0;
+	if (requests_.empty())
+		return;
+
+	// Requests are merged in order, so the result doesn't depend on anything but requests
+	merged_.clear();
+	burstCount_ = 0;
+	soundCount_ = 0;
+	for (const auto& request : requests_)
+		merge(request);
+	requests_.clear();
+
+	for (const auto& request : merged_)
+		emit(request);
+}
+
+// Whether two requests are of the same effect
+bool EffectQueue::isSameEffect(const Request& request, const bool isSound, const char* file, const int zOrder)
+{
+	return request.isSound == isSound && request.zOrder == zOrder && (request.file == file || std::strcmp(request.file, file) == 0);
+}
+
+// Merge request into merged requests
+void EffectQueue::merge(const Request& request)
+{
+	// Closest merged request of the same effect
+	Request* closest = nullptr;
+	auto closestDistanceSq = 0.0f;
+	for (auto& other : merged_) {
+		if (!isSameEffect(other, request.isSound, request.file, request.zOrder))
+			continue;
+		const auto distanceSq = other.pos.distanceSquared(request.pos);
+		if (!closest || distanceSq < closestDistanceSq) {
+			closest = &other;
+			closestDistanceSq = distanceSq;
+		}
+	}
+
+	// Close enough, merged position is the average one
+	if (closest && closestDistanceSq <= EFFECT_MERGE_RADIUS * EFFECT_MERGE_RADIUS) {
+		++closest->count;
+		closest->pos += (request.pos - closest->pos) / static_cast<float>(closest->count);
+		closest->scale = std::max(closest->scale, request.scale);
+		return;
+	}
+
+	// A new effect if there is room for it
+	auto& kindCount = request.isSound ? soundCount_ : burstCount_;
+	if (kindCount < (request.isSound ? EFFECT_MAX_SOUNDS : EFFECT_MAX_BURSTS)) {
+		++kindCount;
+		merged_.push_back(request);
+	}
+	// Otherwise only makes the closest one stronger
+	else if (closest)
+		++closest->count;
+}
+
+// Emit a merged request
+void EffectQueue::emit(const Request& request)
+{
+	// Same effect was emitted here a moment ago
+	for (const auto& recent : recent_)
+		if (recent.isSound == request.isSound && recent.zOrder == request.zOrder && std::strcmp(recent.file, request.file) == 0
+			&& recent.pos.distanceSquared(request.pos) <= EFFECT_MERGE_RADIUS * EFFECT_MERGE_RADIUS)
+			return;
+	recent_.push_back({ request.isSound, request.file, request.zOrder, request.pos, 0 });
+	++lastEmittedCount_;
+
+	if (request.isSound) {
+		AudioManager::getInstance()->playEffect(request.file);
+		return;
+	}
+
+	// Merged bursts are bigger
+	const auto intensity = std::min(1 + EFFECT_MERGE_SCALE_STEP * (request.count - 1), EFFECT_MERGE_MAX_SCALE);
+	auto batch = BurstBatch::getFor(scene_, request.file, request.zOrder);
+	if (request.hasStartColor)
+		batch->addBurst(request.pos, request.startColor, request.scale * intensity, request.tint);
+	else
+		batch->addBurst(request.pos, request.scale * intensity, request.tint);
+}
+
+// Constructor
+EffectQueue::EffectQueue()
+{
+	requests_.reserve(EFFECT_MAX_BURSTS * 4);
+	merged_.reserve(EFFECT_MAX_BURSTS + EFFECT_MAX_SOUNDS);
+	recent_.reserve((EFFECT_MAX_BURSTS + EFFECT_MAX_SOUNDS) * 4);
+}
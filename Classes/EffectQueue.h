@@ -0,0 +1,87 @@
+#ifndef __EFFECT_QUEUE_H__
+#define __EFFECT_QUEUE_H__
+
+#include "cocos2d.h"
+#include <vector>
+
+// Hit effects (particle bursts and sounds) requested by game objects during a physics step
+// Requests of the same effect close to each other are merged into one stronger effect, requests near an effect emitted a moment ago are dropped
+// At most EFFECT_MAX_BURSTS bursts and EFFECT_MAX_SOUNDS sounds are emitted per flush, no matter how many contacts there were
+// Lives in the scene, one queue per scene
+class EffectQueue : public cocos2d::Node
+{
+public:
+	// Return queue of the scene, creates it on first use
+	static EffectQueue* getFor(cocos2d::Scene* scene);
+
+	// Request a burst of particle file at position, it's drawn by the BurstBatch of file and zOrder
+	// File name is kept until flush, so it should be a literal
+	void addBurst(const char* file, int zOrder, const cocos2d::Vec2& pos, float scale = 1, const cocos2d::Color3B& tint = cocos2d::Color3B::WHITE);
+	void addBurst(const char* file, int zOrder, const cocos2d::Vec2& pos, const cocos2d::Color4F& startColor, float scale = 1, const cocos2d::Color3B& tint = cocos2d::Color3B::WHITE);
+	// Request a sound effect that happened at position
+	void addSound(const char* file, const cocos2d::Vec2& pos);
+
+	// Merge requests and emit merged effects, dT is time since the last flush
+	void flush(float dT);
+
+	// Return number of requests and emitted effects of the last flush
+	unsigned int getLastRequestCount() const { return lastRequestCount_; }
+	unsigned int getLastEmittedCount() const { return lastEmittedCount_; }
+
+	CREATE_FUNC(EffectQueue);
+
+private:
+	// One requested or merged effect
+	struct Request
+	{
+		bool isSound;
+		const char* file;
+		int zOrder;
+		cocos2d::Vec2 pos;
+		bool hasStartColor;
+		cocos2d::Color4F startColor;
+		float scale;
+		cocos2d::Color3B tint;
+		unsigned int count; // merged requests
+	};
+	// Effect emitted a moment ago
+	struct Recent
+	{
+		bool isSound;
+		const char* file;
+		int zOrder;
+		cocos2d::Vec2 pos;
+		float time; // since emission
+	};
+
+	// Whether two requests are of the same effect
+	static bool isSameEffect(const Request& request, bool isSound, const char* file, int zOrder);
+	// Merge request into merged requests
+	void merge(const Request& request);
+	// Emit a merged request
+	void emit(const Request& request);
+
+public:
+	// Constructor
+	EffectQueue();
+
+private:
+	// Scene of batches
+	cocos2d::Scene* scene_ = nullptr;
+	// Requests since the last flush
+	std::vector<Request> requests_;
+	// Merged requests, used by flush
+	std::vector<Request> merged_;
+	// Effects emitted during the last EFFECT_MERGE_TIME
+	std::vector<Recent> recent_;
+
+	// Numbers of emitted effects of the current flush
+	unsigned int burstCount_ = 0;
+	unsigned int soundCount_ = 0;
+
+	// Statistics of the last flush
+	unsigned int lastRequestCount_ = 0;
+	unsigned int lastEmittedCount_ = 0;
+};
+
+#endif // __EFFECT_QUEUE_H__
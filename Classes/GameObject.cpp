@@ -1,5 +1,7 @@
 #include "GameObject.h"
 #include "GameObjectEventListener.h"
+#include "EffectQueue.h"
+#include "TransformSync.h"
 #include "Physics/Physics.h"
 
 USING_NS_CC;
@@ -7,6 +9,11 @@ USING_NS_CC;
 // Increment life time
 void GameObject::step(const float dT)
 {
+	// Headless objects have no nodes to interpolate
+	if (transformSync_ && previousPosition_ != getPosition()) {
+		previousPosition_ = getPosition();
+		markDirty();
+	}
 	PhysBody::step(dT);
 
 	lifeTime_ += dT;
@@ -27,19 +34,27 @@ void GameObject::removeListener(GameObjectEventListener* listener)
 }
 
 // Update position and inform the world about it
-// Also set new node position to move sprites
+// Nodes are moved by TransformSync
 void GameObject::setPosition(const Vec2& pos)
 {
 	PhysBody::setPosition(pos);
-	rootNode_->setPosition(pos);
+	markDirty();
 }
 
 // Set activeness and inform the world
 // Also changes visibility
 void GameObject::setActive(const bool active)
 {
+	if (isActive() == active)
+		return; // no event, so that listeners (e.g. pools) don't get it twice
 	PhysBody::setActive(active);
 
+	// Pooled objects are activated after being moved, they shouldn't fly in from where they were
+	if (active) {
+		previousPosition_ = getPosition();
+		markDirty();
+	}
+
 	// Send event
 	if (active)
 		for (auto listener : listeners_)
@@ -51,11 +66,51 @@ void GameObject::setActive(const bool active)
 
 // Adds game object to scene
 void GameObject::addToScene(Scene* scene, const int zLevel)
+{
+	attachToScene(scene);
+	rootNode_ = Node::create();
+	rootNode_->setPosition(getPosition());
+	scene->addChild(rootNode_, zLevel);
+}
+
+// Remember scene, its effects and transform sync without creating the root node
+void GameObject::attachToScene(Scene* scene)
 {
 	if (!scene)
 		throw std::invalid_argument("scene can't be nullptr");
-	scene->addChild(rootNode_, zLevel);
 	sceneNode_ = scene;
+	effects_ = EffectQueue::getFor(scene);
+	transformSync_ = TransformSync::getFor(scene);
+	previousPosition_ = getPosition();
+}
+
+// Move nodes to the position between the previous and the current one
+bool GameObject::syncToScene(const float alpha)
+{
+	const auto& pos = getPosition();
+	if (alpha >= 1 || previousPosition_ == pos) {
+		moveNodes(pos);
+		return false;
+	}
+	moveNodes(previousPosition_.lerp(pos, alpha));
+	return true;
+}
+
+// Move scene nodes to position
+void GameObject::moveNodes(const Vec2& pos)
+{
+	if (!rootNode_)
+		return;
+	rootNode_->setPosition(pos);
+	// Nodes outside the view aren't visited
+	rootNode_->setVisible(transformSync_->isInView(pos));
+}
+
+// Add to dirty objects of the transform sync
+void GameObject::markDirty()
+{
+	if (transformSync_)
+		transformSync_->add(this);
 }
 
 // Destroy this object
@@ -73,14 +128,13 @@ void GameObject::destroy()
 }
 
 // Constructor
-GameObject::GameObject(const Vec2& pos, const float& mass, const float& bounciness) : PhysBody(pos, mass, bounciness)
-{
-	rootNode_ = Node::create();
-	rootNode_->setPosition(pos);
-}
+GameObject::GameObject(const Vec2& pos, const float& mass, const float& bounciness) : PhysBody(pos, mass, bounciness) {}
 // Destructor
 GameObject::~GameObject() {
+	if (transformSync_)
+		transformSync_->remove(this);
 	// We only clean rootNode_ when GameObject is actually destroyed
 	// It would cause bugs if done in destroy()
-	rootNode_->removeFromParentAndCleanup(true);
+	if (rootNode_)
+		rootNode_->removeFromParentAndCleanup(true);
 }
@@ -7,12 +7,18 @@
 
 // Forward declarations
 class GameObjectEventListener;
+class EffectQueue;
+class TransformSync;
 
 // Basic game object that has (is) a physics body and cointains a scene node to attach sprites to
 class GameObject : public PhysBody
 {
+	// Tracks dirty objects by their index
+	friend class TransformSync;
+
 public:
 	// Increment life time
+	// Also remembers position before the step, nodes are drawn between it and the new one
 	virtual void step(float dT) override;
 
 	// Add/remove listeners
@@ -20,14 +26,16 @@ public:
 	void removeListener(GameObjectEventListener* listener);
 
 	// Update position and inform the world about it
-	// Also set new node position to move sprites
+	// Nodes aren't moved here, object is marked dirty and TransformSync moves them once per frame
 	virtual void setPosition(const cocos2d::Vec2& pos) override;
 
 	// Set activeness and inform the world
-	// Also changes visibility
+	// Activated objects are drawn at their position right away, without interpolating from where they were
 	virtual void setActive(bool active) override;
 
 	// Adds game object to scene
+	// Scene nodes (sprites, particles) are only created here
+	// Objects that are never added to a scene are simulated without any visuals
 	virtual void addToScene(cocos2d::Scene* scene, int zLevel = 0);
 
 	// Return life time
@@ -41,9 +49,25 @@ public:
 
 	// Destroy this object, calls onDestroy first for children to add functionality
 	void destroy();
+
+	// Move nodes to the position between the previous and the current one, called by TransformSync
+	// Returns false once nodes are at the current position
+	bool syncToScene(float alpha);
 protected:
 	virtual void onDestroy() {}
 
+	// Remember scene, its effects and transform sync without creating the root node
+	// Used by objects that are drawn by a batch of the scene
+	void attachToScene(cocos2d::Scene* scene);
+
+	// Move scene nodes to position, hides the root node outside the view
+	// Children that draw without the root node override this
+	virtual void moveNodes(const cocos2d::Vec2& pos);
+
+	// Add to dirty objects of the transform sync
+	// Children call it when their nodes change without moving, e.g. turn
+	void markDirty();
+
 public:
 	// Constructor
 	explicit GameObject(const cocos2d::Vec2& pos = cocos2d::Vec2::ZERO, const float& mass = 1, const float& bounciness = 1);
@@ -52,11 +76,22 @@ public:
 
 protected:
 	// Root of the object
-	cocos2d::Node* rootNode_;
+	// nullptr until object is added to a scene
+	cocos2d::Node* rootNode_ = nullptr;
 	// Scene
 	cocos2d::Scene* sceneNode_ = nullptr;
+	// Hit effects of the scene
+	EffectQueue* effects_ = nullptr;
 
 private:
+	// Moves nodes once per frame, nullptr until object is added to a scene
+	TransformSync* transformSync_ = nullptr;
+	// Position before the last step
+	cocos2d::Vec2 previousPosition_;
+	// Index in dirty objects of the transform sync
+	static const unsigned int NOT_DIRTY = static_cast<unsigned int>(-1);
+	unsigned int dirtyIndex_ = NOT_DIRTY;
+
 	// Event listeners
 	std::unordered_set<GameObjectEventListener*> listeners_;
 
@@ -2,7 +2,11 @@
 
 #include "MenuScene.h"
 #include "GameScene.h"
+#include "ParticleCache.h"
 #include "Definitions.h"
+#include "AudioManager.h"
+#include "Trace.h"
+#include "AllocationTracker.h"
 
 #include "audio/include/SimpleAudioEngine.h"
 using namespace CocosDenshion;
@@ -37,7 +41,7 @@ bool GameOverScene::init()
 	this->addChild(backSprite, Z_LEVEL_BACKGROUND);
 
 	// Galaxy particles
-	auto galaxy = ParticleSystemQuad::create(STARS_PARTICLES);
+	auto galaxy = ParticleCache::getInstance()->create(STARS_PARTICLES);
 	galaxy->setPosition(CENTER);
 	this->addChild(galaxy, Z_LEVEL_STARS);
 
@@ -133,7 +137,9 @@ bool GameOverScene::init()
 // Retry the game
 void GameOverScene::menuRetryCallback(cocos2d::Ref* sender)
 {
-	SimpleAudioEngine::getInstance()->playEffect(CLICK_SOUND_EFFECT);
+	AudioManager::getInstance()->playEffect(CLICK_SOUND_EFFECT);
+	TRACE_SCOPE("Transition to GameScene");
+	ALLOCATION_SCOPE("Scenes");
 	const auto scene = GameScene::createScene();
 	Director::getInstance()->replaceScene(SCENE_TRANSITION(scene));
 }
@@ -141,7 +147,9 @@ void GameOverScene::menuRetryCallback(cocos2d::Ref* sender)
 // Returns to menu
 void GameOverScene::menuMenuCallback(cocos2d::Ref* sender)
 {
-	SimpleAudioEngine::getInstance()->playEffect(CLICK_SOUND_EFFECT);
+	AudioManager::getInstance()->playEffect(CLICK_SOUND_EFFECT);
+	TRACE_SCOPE("Transition to MenuScene");
+	ALLOCATION_SCOPE("Scenes");
 	const auto scene = MenuScene::createScene();
 	Director::getInstance()->replaceScene(SCENE_TRANSITION(scene));
 }
@@ -149,7 +157,7 @@ void GameOverScene::menuMenuCallback(cocos2d::Ref* sender)
 // Exits the game
 void GameOverScene::menuExitCallback(cocos2d::Ref* sender)
 {
-	SimpleAudioEngine::getInstance()->playEffect(CLICK_SOUND_EFFECT);
+	AudioManager::getInstance()->playEffect(CLICK_SOUND_EFFECT);
 	Director::getInstance()->end();
 }
 
@@ -161,7 +169,7 @@ void GameOverScene::updateShownNumber(float dT)
 	shownNumber_ += dir;
 
 	numberLabel_->setString(__String::createWithFormat("%d", shownNumber_)->getCString());
-	SimpleAudioEngine::getInstance()->playEffect(SCORE_TICK_SOUND_EFFECT);
+	AudioManager::getInstance()->playEffect(SCORE_TICK_SOUND_EFFECT);
 
 	if (shownNumber_ * dir > shownBNumber_ * dir) {
 		shownBNumber_ += dir;
@@ -0,0 +1,170 @@
+#include "GameRecording.h"
+
+#include <cstring>
+#include <cstdint>
+
+USING_NS_CC;
+
+// Binary format (little-endian):
+//   magic "GREC", version (uint16)
+//   config: maxScore, projectileSpeed, maxGameTime, asteroidMaxSpeed, asteroidMinScale, asteroidMaxScale, seed, origin, size
+//   number of runs (uint32)
+//   runs: count (uint16), dT, aim (2 floats), flags (uint8)
+// Flags hold signs of both axes (2 bits each) and shooting (1 bit)
+#define RECORDING_MAGIC "GREC"
+#define RECORDING_VERSION 1
+#define RECORDING_MAX_RUN_COUNT 0xFFFF
+
+// Write values to binary data
+static void writeUInt(std::string& data, const uint32_t value, const unsigned int bytes)
+{
+	for (unsigned int i = 0; i < bytes; ++i)
+		data.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+static void writeFloat(std::string& data, const float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	writeUInt(data, bits, 4);
+}
+
+// Read values from binary data
+// Throw invalid_argument if data ends too early
+static uint32_t readUInt(const std::string& data, size_t& position, const unsigned int bytes)
+{
+	if (position + bytes > data.size())
+		throw std::invalid_argument("invalid format of game recording");
+	uint32_t value = 0;
+	for (unsigned int i = 0; i < bytes; ++i)
+		value |= static_cast<uint32_t>(static_cast<unsigned char>(data[position++])) << (8 * i);
+	return value;
+}
+static float readFloat(const std::string& data, size_t& position)
+{
+	const auto bits = readUInt(data, position, 4);
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+// Axis values are stored as their signs
+static unsigned int encodeAxis(const float value)
+{
+	return value > 0 ? 1 : (value < 0 ? 2 : 0);
+}
+static float decodeAxis(const unsigned int bits)
+{
+	return bits == 1 ? 1.0f : (bits == 2 ? -1.0f : 0.0f);
+}
+
+// Create recording from binary data
+// Throws invalid_argument if data is not a recording
+GameRecording GameRecording::deserialize(const std::string& data)
+{
+	if (data.compare(0, 4, RECORDING_MAGIC) != 0)
+		throw std::invalid_argument("invalid format of game recording");
+	size_t position = 4;
+	if (readUInt(data, position, 2) != RECORDING_VERSION)
+		throw std::invalid_argument("unsupported version of game recording");
+
+	GameSimulationConfig config;
+	config.maxScore = readUInt(data, position, 4);
+	config.projectileSpeed = readFloat(data, position);
+	config.maxGameTime = readUInt(data, position, 4);
+	config.asteroidMaxSpeed = readFloat(data, position);
+	config.asteroidMinScale = readFloat(data, position);
+	config.asteroidMaxScale = readFloat(data, position);
+	config.seed = readUInt(data, position, 4);
+	config.origin.x = readFloat(data, position);
+	config.origin.y = readFloat(data, position);
+	config.size.width = readFloat(data, position);
+	config.size.height = readFloat(data, position);
+
+	GameRecording recording(config);
+	const auto nRuns = readUInt(data, position, 4);
+	for (uint32_t i = 0; i < nRuns; ++i) {
+		const auto count = readUInt(data, position, 2);
+		Run run;
+		run.dT = readFloat(data, position);
+		run.input.aim.x = readFloat(data, position);
+		run.input.aim.y = readFloat(data, position);
+		const auto flags = readUInt(data, position, 1);
+		run.input.axis = Vec2(decodeAxis(flags & 3), decodeAxis((flags >> 2) & 3));
+		run.input.shooting = (flags & 16) != 0;
+		for (uint32_t c = 0; c < count; ++c)
+			recording.addStep(run.dT, run.input);
+	}
+	return recording;
+}
+
+// Binary data of the recording
+std::string GameRecording::serialize() const
+{
+	std::string data = RECORDING_MAGIC;
+	writeUInt(data, RECORDING_VERSION, 2);
+
+	writeUInt(data, config_.maxScore, 4);
+	writeFloat(data, config_.projectileSpeed);
+	writeUInt(data, config_.maxGameTime, 4);
+	writeFloat(data, config_.asteroidMaxSpeed);
+	writeFloat(data, config_.asteroidMinScale);
+	writeFloat(data, config_.asteroidMaxScale);
+	writeUInt(data, config_.seed, 4);
+	writeFloat(data, config_.origin.x);
+	writeFloat(data, config_.origin.y);
+	writeFloat(data, config_.size.width);
+	writeFloat(data, config_.size.height);
+
+	writeUInt(data, static_cast<uint32_t>(runs_.size()), 4);
+	for (const auto& run : runs_) {
+		writeUInt(data, run.count, 2);
+		writeFloat(data, run.dT);
+		writeFloat(data, run.input.aim.x);
+		writeFloat(data, run.input.aim.y);
+		writeUInt(data, encodeAxis(run.input.axis.x) | encodeAxis(run.input.axis.y) << 2 | (run.input.shooting ? 16 : 0), 1);
+	}
+	return data;
+}
+
+// Add one step
+void GameRecording::addStep(const float dT, const GameInput& input)
+{
+	GameInput stored = input;
+	stored.axis = Vec2(decodeAxis(encodeAxis(input.axis.x)), decodeAxis(encodeAxis(input.axis.y)));
+
+	++stepCount_;
+	if (!runs_.empty()) {
+		auto& last = runs_.back();
+		if (last.count < RECORDING_MAX_RUN_COUNT && last.dT == dT && last.input.aim == stored.aim &&
+			last.input.axis == stored.axis && last.input.shooting == stored.shooting) {
+			++last.count;
+			return;
+		}
+	}
+	runs_.push_back({ dT, stored, 1 });
+}
+
+// Read next step, returns false when there are no steps left
+bool GameRecording::readStep(float& dT, GameInput& input)
+{
+	if (readRun_ >= runs_.size())
+		return false;
+
+	const auto& run = runs_[readRun_];
+	dT = run.dT;
+	input = run.input;
+	if (++readCount_ >= run.count) {
+		++readRun_;
+		readCount_ = 0;
+	}
+	return true;
+}
+// Start reading from the first step
+void GameRecording::rewind()
+{
+	readRun_ = 0;
+	readCount_ = 0;
+}
+
+// Constructor
+GameRecording::GameRecording(const GameSimulationConfig& config) : config_(config) {}
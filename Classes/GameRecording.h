@@ -0,0 +1,57 @@
+#ifndef __GAME_RECORDING_H__
+#define __GAME_RECORDING_H__
+
+#include "GameSimulation.h"
+#include <string>
+#include <vector>
+
+// Everything needed to play the same game again: parameters, seed and player's input for every step
+// Can be saved to compact binary data and loaded back
+// Since simulation is deterministic, replaying a recording gives exactly the same game
+class GameRecording
+{
+public:
+	// Create recording from binary data
+	// Throws invalid_argument if data is not a recording
+	static GameRecording deserialize(const std::string& data);
+	// Binary data of the recording
+	std::string serialize() const;
+
+	// Add one step
+	void addStep(float dT, const GameInput& input);
+
+	// Read next step, returns false when there are no steps left
+	bool readStep(float& dT, GameInput& input);
+	// Start reading from the first step
+	void rewind();
+
+	// Return parameters of the recorded game
+	const GameSimulationConfig& getConfig() const { return config_; }
+	// Return number of recorded steps
+	unsigned int getStepCount() const { return stepCount_; }
+
+	// Constructor
+	explicit GameRecording(const GameSimulationConfig& config);
+
+private:
+	// Equal consecutive steps are stored once
+	struct Run
+	{
+		float dT;
+		GameInput input;
+		unsigned int count;
+	};
+
+	// Parameters of the game
+	GameSimulationConfig config_;
+
+	// Recorded steps
+	std::vector<Run> runs_;
+	unsigned int stepCount_ = 0;
+
+	// Reading position
+	size_t readRun_ = 0;
+	unsigned int readCount_ = 0;
+};
+
+#endif // __GAME_RECORDING_H__
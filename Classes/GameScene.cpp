@@ -2,13 +2,20 @@
 
 #include "MenuScene.h"
 #include "GameOverScene.h"
+#include "GameSimulation.h"
 #include "Gunship.h"
-#include "Target.h"
-#include "Asteroid.h"
+#include "GameRecording.h"
+#include "BurstBatch.h"
+#include "EffectQueue.h"
+#include "TransformSync.h"
+#include "ParticleCache.h"
+#include "AudioManager.h"
 #include "Physics/Physics.h"
 #include "Definitions.h"
+#include "Trace.h"
+#include "AllocationTracker.h"
+#include <cmath>
 #include <ctime>
-#include <numeric>
 
 #include "audio/include/SimpleAudioEngine.h"
 using namespace CocosDenshion;
@@ -27,39 +34,26 @@ bool GameScene::init()
 	if (!Scene::init())
 		return false;
 
-	// Seed randomness
-	std::srand(std::time(nullptr));
-
-	// Read some data from file
-	const auto input = FileUtils::getInstance()->getStringFromFile(INPUT_FILE);
-	std::stringstream inputStream(input);
-	// Initialize temporary data
-	auto maxScore = 0;
-	auto projectileSpeed = 0;
-	auto maxGameTime = 0;
-	std::string tag;
-	// Check all lines
-	// We allow empty lines or lines of other format along lines that SHOULD be there
-	while (!inputStream.eof()) {
-		std::string line;
-		std::getline(inputStream, line);
-		std::stringstream lineStream(line);
-		// Find tag
-		std::getline(lineStream, tag, '=');
-		// Check what tag is it
-		if (tag == INPUT_COUNT_TARGET_TAG)
-			lineStream >> maxScore;
-		else if (tag == INPUT_PROJECTILE_SPEED_TAG)
-			lineStream >> projectileSpeed;
-		else if (tag == INPUT_GAME_TIME_TAG)
-			lineStream >> maxGameTime;
+	// Replay recorded game if there is one
+	replaying_ = FileUtils::getInstance()->isFileExist(REPLAY_FILE);
+	if (replaying_) {
+		const auto data = FileUtils::getInstance()->getDataFromFile(REPLAY_FILE);
+		recording_ = std::make_unique<GameRecording>(GameRecording::deserialize(std::string(reinterpret_cast<const char*>(data.getBytes()), data.getSize())));
+		CCLOG("Replaying game with seed %u, %u steps", recording_->getConfig().seed, recording_->getStepCount());
 	}
-	// Check if data format is correct (all data is correctly initialized)
-	if (maxScore <= 0 || projectileSpeed <= 0 || maxGameTime <= 0)
-		throw std::invalid_argument(std::string("invalid format of ") + INPUT_FILE);
-	// Initialize actual data
-	maxScore_ = maxScore;
-	maxGameTime_ = maxGameTime;
+	else {
+		// Read some data from file
+		auto config = GameSimulation::readConfig(FileUtils::getInstance()->getStringFromFile(INPUT_FILE));
+		// Seed randomness, unless seed is set in file
+		if (config.seed == 0)
+			config.seed = std::time(nullptr);
+		CCLOG("Game seed: %u", config.seed);
+		config.origin = ORIGIN;
+		config.size = V_SIZE;
+		recording_ = std::make_unique<GameRecording>(config);
+	}
+	// Recorded games keep their own visible area, so that physics is the same
+	const auto& config = recording_->getConfig();
 
 	// Background music
 	SimpleAudioEngine::getInstance()->playBackgroundMusic(GAME_BACKGROUND_MUSIC, true);
@@ -70,12 +64,12 @@ bool GameScene::init()
 	this->addChild(backSprite, Z_LEVEL_BACKGROUND);
 
 	// Galaxy particles
-	auto galaxy = ParticleSystemQuad::create(STARS_PARTICLES);
+	auto galaxy = ParticleCache::getInstance()->create(STARS_PARTICLES);
 	galaxy->setPosition(CENTER);
 	this->addChild(galaxy, Z_LEVEL_STARS);
 
 	// Set label for targets (score) 
-	scoreLabel_ = Label::createWithTTF(__String::createWithFormat("Score: %d / %d", 0, maxScore_)->getCString(), MAIN_FONT, GAME_UI_FONT_SIZE);
+	scoreLabel_ = Label::createWithTTF(__String::createWithFormat("Score: %d / %d", 0, config.maxScore)->getCString(), MAIN_FONT, GAME_UI_FONT_SIZE);
 	const auto scoreLeftOffset = 0.04 * V_SIZE.width;
 	const auto scoreTopOffset = scoreLeftOffset;
 	scoreLabel_->setPosition(
@@ -88,7 +82,7 @@ bool GameScene::init()
 	this->addChild(scoreLabel_, Z_LEVEL_UI);
 
 	// Set label for game time 
-	gameTimeLabel_ = Label::createWithTTF(__String::createWithFormat("Time left: %d", maxGameTime_)->getCString(), MAIN_FONT, GAME_UI_FONT_SIZE);
+	gameTimeLabel_ = Label::createWithTTF(__String::createWithFormat("Time left: %d", config.maxGameTime)->getCString(), MAIN_FONT, GAME_UI_FONT_SIZE);
 	const auto timeRightOffset = scoreLeftOffset;
 	const auto timeTopOffset = timeRightOffset;
 	gameTimeLabel_->setPosition(
@@ -113,91 +107,36 @@ bool GameScene::init()
 	menu->setPosition(Vec2::ZERO);
 	this->addChild(menu, Z_LEVEL_UI);
 
+#if PHYS_PROFILING
+	// Physics statistics, hidden until toggled
+	profiler_ = std::make_unique<PhysProfiler>();
+	profilerLabel_ = Label::createWithTTF("", MAIN_FONT, PROFILER_HUD_FONT_SIZE);
+	profilerLabel_->setAnchorPoint(Vec2::ANCHOR_TOP_LEFT);
+	profilerLabel_->setPosition(ORIGIN.x + scoreLeftOffset, scoreLabel_->getPositionY() - scoreLabel_->getContentSize().height);
+	profilerLabel_->setAlignment(TextHAlignment::LEFT);
+	profilerLabel_->setColor(GAME_UI_COLOR);
+	profilerLabel_->setVisible(false);
+	this->addChild(profilerLabel_, Z_LEVEL_UI);
+#endif
+
 	// Create cursor particles
-	cursor_ = ParticleSystemQuad::create(CURSOR_PARTICLES);
+	cursor_ = ParticleCache::getInstance()->create(CURSOR_PARTICLES);
 	cursor_->setPosition(-CENTER); // somewhere outside
 	this->addChild(cursor_, Z_LEVEL_UI);
 	// Hide default cursor
 	Director::getInstance()->getOpenGLView()->setCursorVisible(false);
 
-	// Create physics world
-	sceneWorld_ = std::make_unique<PhysWorld>(ORIGIN - PARTITIONS_OUTSIDE_OFFSET * V_SIZE, V_SIZE * (1 + 2 * PARTITIONS_OUTSIDE_OFFSET));
-
-	// Create edge around screen
-	auto edgeBody = std::make_unique<PhysBody>(CENTER);
-	edgeBody->addCollider(std::make_unique<PhysBoxCollider>(Vec2(0, (V_SIZE.height + EDGE_WIDTH) / 2), Size(V_SIZE.width, EDGE_WIDTH), EDGE_BITMASKS));  // top
-	edgeBody->addCollider(std::make_unique<PhysBoxCollider>(Vec2(0, -(V_SIZE.height + EDGE_WIDTH) / 2), Size(V_SIZE.width, EDGE_WIDTH), EDGE_BITMASKS)); // bottom
-	edgeBody->addCollider(std::make_unique<PhysBoxCollider>(Vec2((V_SIZE.width + EDGE_WIDTH) / 2, 0), Size(EDGE_WIDTH, V_SIZE.height), EDGE_BITMASKS));  // right
-	edgeBody->addCollider(std::make_unique<PhysBoxCollider>(Vec2(-(V_SIZE.width + EDGE_WIDTH) / 2, 0), Size(EDGE_WIDTH, V_SIZE.height), EDGE_BITMASKS)); // left
-	sceneWorld_->addBody(std::move(edgeBody));
-
-	// Create a gunship in the center of the screen
-	auto gunship = std::make_unique<Gunship>(CENTER, projectileSpeed);
-	gunship_ = gunship.get(); // save pointer for easy access
-	gunship->addToScene(this, Z_LEVEL_GUNSHIP); // add cocos2d node to scene
-	sceneWorld_->addBody(std::move(gunship)); // PhysWorld controls memory
-
-	// We create it just to find normal size
-	auto tempGunship = Sprite::create();
-	tempGunship->initWithFile(GUNSHIP_SPRITE);
-	const auto gunshipSize = tempGunship->getContentSize();
-
-	// We create it just to find normal size
-	auto tempAsteroid = Sprite::create();
-	tempAsteroid->initWithFile(ASTEROID_SPRITE);
-	const auto asteroidSize = tempAsteroid->getContentSize();
-	const auto maxAsteroidSize = asteroidSize * ASTEROID_MAX_SCALE;
-
-	// Rescale asteroids if too many of them have to be on the screen
-	const auto square = V_SIZE.width * V_SIZE.height;
-	auto cellSide = std::sqrt(square * ASTEROIDS_SPARCITY / maxScore_);
-	if (cellSide > maxAsteroidSize.width) cellSide = maxAsteroidSize.width; // we don't want cells to be too big with fewer asteroids
-	const unsigned int nX = std::floor(V_SIZE.width / cellSide) + 1;
-	const unsigned int nY = std::floor(V_SIZE.height / cellSide) + 1;
-	cellSide = std::min(V_SIZE.width / nX, V_SIZE.height / nY);
-	const auto extraScale = cellSide / maxAsteroidSize.width;
-
-	// Create cells where asteroids can be placed
-	const auto nCells = nX * nY;
-	std::vector<unsigned int> cellIndices(nCells);
-	std::iota(cellIndices.begin(), cellIndices.end(), 0);
-	std::shuffle(cellIndices.begin(), cellIndices.end(), std::mt19937(std::random_device()())); // shuffle indices
-	// Create all asteroids in random positions with random speeds and scales
-	unsigned int placed = 0;
-	for(unsigned int i = 0; i < nCells && placed < maxScore_; ++i) {
-		const auto column = cellIndices[i] % nX;
-		const auto row = cellIndices[i] / nX;
-		const auto center = ORIGIN + (Vec2(column, row) + Vec2(0.5, 0.5)) * cellSide;
-
-		// Check if cell is ok (not near center)
-		if (std::abs(CENTER_X - center.x) < cellSide / 2 + gunshipSize.width / 2 &&
-			std::abs(CENTER_Y - center.y) < cellSide / 2 + gunshipSize.height / 2)
-			continue;
-
-		auto const relativeScale = (ASTEROID_MIN_SCALE + rand_0_1() * (ASTEROID_MAX_SCALE - ASTEROID_MIN_SCALE));
-		auto scale = relativeScale * extraScale;
-		const auto size = asteroidSize * scale;
-		auto position = center + Vec2((cellSide - size.width) * rand_minus1_1(), (cellSide - size.height) * rand_minus1_1()) / 2;
-		auto speed = Vec2::ONE.rotateByAngle(Vec2::ZERO, rand_0_1() * CC_DEGREES_TO_RADIANS(360)) // random direction
-			* rand_0_1() * ASTEROID_MAX_SPEED * V_SIZE.width / (relativeScale * relativeScale);  // random magnitude
-		std::unique_ptr<PhysMovement> movement;
-		Color3B color;
-		if (rand_0_1() > 0.5) {
-			movement = std::make_unique<PhysMovement>(speed);
-			color = Color3B::WHITE;
-		}
-		else {
-			auto angularSpeed = rand_minus1_1() * CC_DEGREES_TO_RADIANS(ASTEROID_MAX_ANGULAR_SPEED);
-			auto curveTime = ASTEROID_MIN_CURVE_TIME + rand_0_1() * (ASTEROID_MAX_CURVE_TIME - ASTEROID_MIN_CURVE_TIME);
-			movement = std::make_unique<PhysLeftRightMovement>(speed, angularSpeed, curveTime);
-			color = ASTEROIDS_CURVED_COLOR;
-		}
-		auto asteroid = std::make_unique<Asteroid>(position, std::move(movement), scale, color);
-		asteroid->addListener(this); // start listening to target events
-		asteroid->addToScene(this, Z_LEVEL_TARGET); // add cocos2d node to scene
-		sceneWorld_->addBody(std::move(asteroid));
-		++placed;
-	}
+	// Create batches of hit effects before the game starts
+	BurstBatch::getFor(this, LASER_BALL_BOUNCED_PARTICLES, Z_LEVEL_PROJECTILE);
+	BurstBatch::getFor(this, GUNSHIP_BOUNCED_PARTICLES, Z_LEVEL_GUNSHIP);
+	BurstBatch::getFor(this, ASTEROID_BOUNCED_PARTICLES, Z_LEVEL_TARGET);
+	BurstBatch::getFor(this, ASTEROID_BREAK_PARTICLES, Z_LEVEL_TARGET);
+	effects_ = EffectQueue::getFor(this);
+	transformSync_ = TransformSync::getFor(this);
+
+	// Create physics world with gunship and asteroids
+	simulation_ = std::make_unique<GameSimulation>(config, this);
+	simulation_->setListener(this);
 
 	// Start listening to mouse
 	auto mouseListener = EventListenerMouse::create();
@@ -231,10 +170,28 @@ void GameScene::beforeLeavingScene()
 {
 	unscheduleAllCallbacks();
 
+	saveRecording();
+
 	// Show default cursor
 	Director::getInstance()->getOpenGLView()->setCursorVisible(true);
 
-	// memory for sceneWorld_ will be freed automatically
+	// memory for simulation_ will be freed automatically
+}
+
+// Save recording of the game
+void GameScene::saveRecording()
+{
+	// Replays and games that were already saved are not saved
+	if (replaying_ || !recording_ || recording_->getStepCount() == 0)
+		return;
+
+	const auto data = recording_->serialize();
+	Data fileData;
+	fileData.copy(reinterpret_cast<const unsigned char*>(data.data()), data.size());
+	const auto path = FileUtils::getInstance()->getWritablePath() + RECORDING_FILE;
+	if (FileUtils::getInstance()->writeDataToFile(fileData, path))
+		CCLOG("Game recorded to %s", path.c_str());
+	recording_.reset();
 }
 
 // Go to game over screen
@@ -242,7 +199,9 @@ void GameScene::continueToGameOver(float dT)
 {
 	beforeLeavingScene(); // Stops schedules
 
-	const auto scene = GameOverScene::createScene(score_, maxScore_, gameTime_, maxGameTime_);
+	TRACE_SCOPE("Transition to GameOverScene");
+	ALLOCATION_SCOPE("Scenes");
+	const auto scene = GameOverScene::createScene(simulation_->getScore(), simulation_->getMaxScore(), simulation_->getGameTime(), simulation_->getMaxGameTime());
 	Director::getInstance()->replaceScene(SCENE_TRANSITION(scene));
 }
 
@@ -253,6 +212,8 @@ void GameScene::menuCallback(Ref* sender)
 
 	SimpleAudioEngine::getInstance()->playBackgroundMusic(MENU_BACKGROUND_MUSIC, true);
 
+	TRACE_SCOPE("Transition to MenuScene");
+	ALLOCATION_SCOPE("Scenes");
 	const auto scene = MenuScene::createScene();
 	Director::getInstance()->replaceScene(SCENE_TRANSITION(scene));
 }
@@ -262,6 +223,8 @@ void GameScene::retryCallback(Ref* sender)
 {
 	beforeLeavingScene(); // Stops schedules
 
+	TRACE_SCOPE("Transition to GameScene");
+	ALLOCATION_SCOPE("Scenes");
 	const auto scene = GameScene::createScene();
 	Director::getInstance()->replaceScene(SCENE_TRANSITION(scene));
 }
@@ -270,16 +233,18 @@ void GameScene::retryCallback(Ref* sender)
 // Shoot while mouse is down
 void GameScene::onMouseDown(EventMouse* event)
 {
-	gunship_->startShooting();
+	mouseDown_ = true;
 }
 void GameScene::onMouseUp(EventMouse* event)
 {
-	gunship_->stopShooting();
+	mouseDown_ = false;
 }
 void GameScene::onMouseMove(EventMouse* event)
 {
 	mouseLocation_ = event->getLocationInView();
-	cursor_->setPosition(mouseLocation_);
+	// When replaying, cursor shows recorded aim
+	if (!replaying_)
+		cursor_->setPosition(mouseLocation_);
 }
 
 // Handle keyboard events
@@ -293,6 +258,18 @@ void GameScene::onKeyPressed(const EventKeyboard::KeyCode keyCode, Event* event)
 	case EventKeyboard::KeyCode::KEY_R:
 		retryCallback();
 		break;
+	case EventKeyboard::KeyCode::KEY_F3:
+		toggleProfilerHud();
+		break;
+#if TRACING
+	case EventKeyboard::KeyCode::KEY_F4: {
+		// Save timeline of recent frames
+		const auto path = FileUtils::getInstance()->getWritablePath() + TRACE_FILE;
+		if (Trace::writeJson(path))
+			CCLOG("Trace written to %s", path.c_str());
+		break;
+	}
+#endif
 	case EventKeyboard::KeyCode::KEY_UP_ARROW:
 	case EventKeyboard::KeyCode::KEY_W:
 		upPressed_ = true;
@@ -349,72 +326,146 @@ void GameScene::onKeyReleased(const EventKeyboard::KeyCode keyCode, Event* event
 // Start all schedules
 void GameScene::startSchedules(float dT)
 {
-	// Start incrementing time
-	this->schedule(schedule_selector(GameScene::incrementGameTime), 1, maxGameTime_ - 1, 0);
-	// Start updating physics
-	this->schedule(schedule_selector(GameScene::physicsStep), PHYSICS_UPDATE_INTERVAL);
-	// Start general updates
+	// Start updating physics (game time is counted there too)
 	this->scheduleUpdate();
 }
 
-// Increment game time every second
-void GameScene::incrementGameTime(float dT)
+// Run physics steps that are due, in fixed steps
+void GameScene::update(const float dT)
 {
-	if (!playing_)
-		return;
-
-	++gameTime_;
+	TRACE_SCOPE("GameScene::update");
 
-	// Update label
-	gameTimeLabel_->setString(__String::createWithFormat("Time left: %d", maxGameTime_ - gameTime_)->getCString());
+	// Time left over is carried to the next frame, nodes are interpolated by it
+	physicsLag_ += dT;
+	for (auto steps = 0; steps < PHYSICS_MAX_STEPS_PER_FRAME && physicsLag_ >= PHYSICS_UPDATE_INTERVAL; ++steps) {
+		physicsLag_ -= PHYSICS_UPDATE_INTERVAL;
+		physicsStep(PHYSICS_UPDATE_INTERVAL);
+	}
 
-	// Check for loss
-	if (gameTime_ >= maxGameTime_) {
-		// Play sound
-		SimpleAudioEngine::getInstance()->playEffect(TIME_OUT_SOUND_EFFECT);
+	// After a long frame the game slows down instead of catching up, whole steps over the limit are dropped
+	physicsLag_ = std::fmod(physicsLag_, static_cast<float>(PHYSICS_UPDATE_INTERVAL));
+}
 
-		playing_ = false;
-		this->scheduleOnce(schedule_selector(GameScene::continueToGameOver), GAME_OVER_SCENE_TRANSITION_DELAY);
+// Move nodes of game objects to their physics positions before drawing
+void GameScene::visit(Renderer* renderer, const Mat4& parentTransform, const uint32_t parentFlags)
+{
+	const auto frame = Director::getInstance()->getTotalFrames();
+	if (frame != syncedFrame_) {
+		syncedFrame_ = frame;
+		// How far the frame is from the previous step to the last one
+		auto alpha = 1.0f;
+#if PHYSICS_INTERPOLATION
+		alpha = clampf(physicsLag_ / PHYSICS_UPDATE_INTERVAL, 0, 1);
+#endif
+		transformSync_->flush(alpha);
 	}
-	else if (gameTime_ >= maxGameTime_ - TIME_OUT_TIMER)
-		// Play sound
-		SimpleAudioEngine::getInstance()->playEffect(TIME_TICK_SOUND_EFFECT);
+
+	Scene::visit(renderer, parentTransform, parentFlags);
 }
 
-// Handle target destruction
-void GameScene::onGameObjectBeginDestroy(GameObject* sender)
+// Handle game time change
+void GameScene::onGameTimeChanged(const unsigned int gameTime)
 {
-	if (!playing_)
-		return;
+	const auto maxGameTime = simulation_->getMaxGameTime();
 
-	const auto target = dynamic_cast<Target*>(sender);
-	if (!target)
-		return;
+	// Update label
+	gameTimeLabel_->setString(__String::createWithFormat("Time left: %d", maxGameTime - gameTime)->getCString());
 
-	++score_;
+	if (gameTime < maxGameTime && gameTime >= maxGameTime - TIME_OUT_TIMER)
+		// Play sound
+		AudioManager::getInstance()->playEffect(TIME_TICK_SOUND_EFFECT);
+}
 
+// Handle score change
+void GameScene::onScoreChanged(const unsigned int score)
+{
 	// Update label
-	scoreLabel_->setString(__String::createWithFormat("Score: %d / %d", score_, maxScore_)->getCString());
+	scoreLabel_->setString(__String::createWithFormat("Score: %d / %d", score, simulation_->getMaxScore())->getCString());
+}
 
-	// Check for win
-	if (score_ >= maxScore_) {
-		// Play sound
-		SimpleAudioEngine::getInstance()->playEffect(WIN_SOUND_EFFECT);
+// Handle end of the game
+void GameScene::onGameOver(const bool isWin)
+{
+	// Play sound
+	AudioManager::getInstance()->playEffect(isWin ? WIN_SOUND_EFFECT : TIME_OUT_SOUND_EFFECT);
 
-		playing_ = false;
-		this->scheduleOnce(schedule_selector(GameScene::continueToGameOver), GAME_OVER_SCENE_TRANSITION_DELAY);
-	}
+	this->scheduleOnce(schedule_selector(GameScene::continueToGameOver), GAME_OVER_SCENE_TRANSITION_DELAY);
 }
 
 // Update physics
 void GameScene::physicsStep(const float dT)
 {
-	sceneWorld_->step(dT);
+	TRACE_SCOPE("GameScene::physicsStep");
+
+	GameInput input;
+	auto stepDT = dT;
+	if (replaying_) {
+		// Use recorded input and time
+		// Recording of a game the player left early ends before the game, it's over then
+		if (!recording_->readStep(stepDT, input)) {
+			simulation_->endGame();
+			return;
+		}
+		cursor_->setPosition(input.aim);
+	}
+	else {
+		input.aim = mouseLocation_;
+		input.axis = Vec2(xAxis_, yAxis_);
+		input.shooting = mouseDown_;
+		recording_->addStep(dT, input);
+	}
+	simulation_->setInput(input);
+
+	simulation_->step(stepDT);
+	// Emit hit effects of this step
+	effects_->flush(stepDT);
+
+#if PHYS_PROFILING
+	profiler_->addStep(simulation_->getWorld()->getLastStepProfile());
+	if (profilerLabel_->isVisible() && ++profilerHudSteps_ >= PROFILER_HUD_UPDATE_STEPS) {
+		profilerHudSteps_ = 0;
+		updateProfilerHud();
+	}
+#endif
+}
+
+// Show/hide physics statistics
+void GameScene::toggleProfilerHud()
+{
+	if (!profilerLabel_)
+		return; // profiling is compiled out
+
+	profilerLabel_->setVisible(!profilerLabel_->isVisible());
+	if (profilerLabel_->isVisible())
+		updateProfilerHud();
 }
 
-// General update
-void GameScene::update(const float dT)
+// Show statistics of recent physics steps
+void GameScene::updateProfilerHud()
 {
-	gunship_->lookAt(mouseLocation_);
-	gunship_->accelerate(Vec2(xAxis_, yAxis_));
+	if (!profiler_)
+		return;
+
+	std::string text = __String::createWithFormat("Physics, %d steps (us): min / avg / p99\n", static_cast<int>(profiler_->getStepCount()))->getCString();
+	for (size_t i = 0; i < N_PHYS_PHASES; ++i) {
+		const auto phase = static_cast<PhysPhase>(i);
+		const auto stats = profiler_->getPhaseStats(phase);
+		text += __String::createWithFormat("%s: %.1f / %.1f / %.1f\n", PhysStepProfile::getPhaseName(phase), stats.min, stats.average, stats.p99)->getCString();
+	}
+	const auto total = profiler_->getTotalStats();
+	text += __String::createWithFormat("Step: %.1f / %.1f / %.1f\n", total.min, total.average, total.p99)->getCString();
+	text += __String::createWithFormat("Bodies: %.0f, pairs: %.0f, contacts: %.0f, events: %.1f",
+		profiler_->getBodiesStats().average, profiler_->getPairsTestedStats().average,
+		profiler_->getContactsStats().average, profiler_->getEventsStats().average)->getCString();
+
+	// Pool stats help to tune LASER_BALLS_PREWARM
+	const auto& laserBallPool = simulation_->getGunship()->getLaserBallPool();
+	text += __String::createWithFormat("\nLaser balls: %u created, at most %u active at once",
+		laserBallPool.getCreatedCount(), laserBallPool.getHighWaterMark())->getCString();
+	// Audio stats help to tune sound settings
+	const auto& audioStats = AudioManager::getInstance()->getStats();
+	text += __String::createWithFormat("\nSounds: %llu played, %llu too frequent, %llu without a voice, %llu stolen",
+		static_cast<unsigned long long>(audioStats.played), static_cast<unsigned long long>(audioStats.rateLimited),
+		static_cast<unsigned long long>(audioStats.noVoice), static_cast<unsigned long long>(audioStats.stolen))->getCString();
+	profilerLabel_->setString(text);
 }
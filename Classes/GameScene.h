@@ -1,11 +1,11 @@
 #ifndef __GAME_SCENE_H__
 #define __GAME_SCENE_H__
 
-#include "GameObjectEventListener.h"
+#include "GameSimulationEventListener.h"
 #include "cocos2d.h"
 
 // Game scene where game happens
-class GameScene : public cocos2d::Scene, public GameObjectEventListener
+class GameScene : public cocos2d::Scene, public GameSimulationEventListener
 {
 public:
 	static cocos2d::Scene* createScene();
@@ -20,10 +20,12 @@ public:
 	// Stop schedules upon destruction
 	~GameScene();
 
-private:
-	// True if game is on
-	bool playing_ = true;
+	// Run physics steps that are due, in fixed steps
+	virtual void update(float dT) override;
+	// Move nodes of game objects to their physics positions before drawing
+	virtual void visit(cocos2d::Renderer* renderer, const cocos2d::Mat4& parentTransform, uint32_t parentFlags) override;
 
+private:
 	// Stop schedules upon leaving scene
 	void beforeLeavingScene();
 
@@ -42,41 +44,41 @@ private:
 
 	// Position of the mouse
 	cocos2d::Vec2 mouseLocation_;
+	// True while mouse is down
+	bool mouseDown_ = false;
 
 	// Handle keyboard events
 	void onKeyPressed(cocos2d::EventKeyboard::KeyCode keyCode, cocos2d::Event* event);
 	void onKeyReleased(cocos2d::EventKeyboard::KeyCode keyCode, cocos2d::Event* event);
 
-	// Game time
-	unsigned int gameTime_ = 0;
-	unsigned int maxGameTime_ = 0;
-	// Player's score
-	unsigned int score_ = 0;
-	unsigned int maxScore_ = 0;
-
 	// Start all schedules
 	void startSchedules(float dT);
 
-	// Increment game time every second
-	void incrementGameTime(float dT);
+	// Handle game time change
+	virtual void onGameTimeChanged(unsigned int gameTime) override;
 	// This is where game time is shown
 	cocos2d::Label* gameTimeLabel_ = nullptr;
 
-	// Handle target destruction
-	virtual void onGameObjectBeginDestroy(class GameObject* sender) override;
+	// Handle score change
+	virtual void onScoreChanged(unsigned int score) override;
 	// This is where score is shown
 	cocos2d::Label* scoreLabel_ = nullptr;
 
-	// Physics
-	std::unique_ptr<class PhysWorld> sceneWorld_;
-	void physicsStep(float dT); // update physics
+	// Handle end of the game
+	virtual void onGameOver(bool isWin) override;
 
-	// General update
-	virtual void update(float dT) override;
+	// Game rules, physics and all game objects
+	std::unique_ptr<class GameSimulation> simulation_;
+	void physicsStep(float dT); // update physics
+	// Time that wasn't simulated yet, less than one step after update
+	float physicsLag_ = 0;
 
-	// Spaceship
-	// Just a pointer, PhysWorld handles its memory
-	class Gunship* gunship_ = nullptr;
+	// Input of every step, so that the game can be replayed
+	// When replaying, input is read from it instead
+	std::unique_ptr<class GameRecording> recording_;
+	bool replaying_ = false;
+	// Save recording of the game
+	void saveRecording();
 
 	// For spaceship controls
 	bool rightPressed_ = false;
@@ -88,6 +90,20 @@ private:
 
 	// Particles for cursor
 	cocos2d::ParticleSystemQuad* cursor_;
+	// Hit effects requested during physics steps
+	class EffectQueue* effects_ = nullptr;
+	// Moves nodes of game objects moved during physics steps
+	class TransformSync* transformSync_ = nullptr;
+	// Frame of the last sync, scene is visited once per camera
+	unsigned int syncedFrame_ = static_cast<unsigned int>(-1);
+
+	// Overlay with physics step statistics, toggled with F3
+	// Only works when PHYS_PROFILING is enabled (debug builds)
+	void toggleProfilerHud();
+	void updateProfilerHud();
+	std::unique_ptr<class PhysProfiler> profiler_;
+	cocos2d::Label* profilerLabel_ = nullptr;
+	unsigned int profilerHudSteps_ = 0;
 };
 
 #endif // __GAME_SCENE_H__
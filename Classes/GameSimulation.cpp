@@ -0,0 +1,283 @@
+#include "GameSimulation.h"
+
+#include "GameSimulationEventListener.h"
+#include "Gunship.h"
+#include "Target.h"
+#include "Asteroid.h"
+#include "SpriteManifest.h"
+#include "Physics/Physics.h"
+#include "Definitions.h"
+#include "Trace.h"
+#include "AllocationTracker.h"
+#include <numeric>
+#include <limits>
+
+USING_NS_CC;
+
+// Constructor
+GameSimulationConfig::GameSimulationConfig() : asteroidMaxSpeed(ASTEROID_MAX_SPEED), asteroidMinScale(ASTEROID_MIN_SCALE), asteroidMaxScale(ASTEROID_MAX_SCALE) {}
+
+// Read game parameters from contents of input file
+GameSimulationConfig GameSimulation::readConfig(const std::string& input)
+{
+	std::stringstream inputStream(input);
+	// Initialize temporary data
+	auto maxScore = 0;
+	auto projectileSpeed = 0;
+	auto maxGameTime = 0;
+	// Optional data
+	unsigned int seed = 0;
+	float asteroidMaxSpeed = ASTEROID_MAX_SPEED;
+	float asteroidMinScale = ASTEROID_MIN_SCALE;
+	float asteroidMaxScale = ASTEROID_MAX_SCALE;
+	std::string tag;
+	// Check all lines
+	// We allow empty lines or lines of other format along lines that SHOULD be there
+	while (!inputStream.eof()) {
+		std::string line;
+		std::getline(inputStream, line);
+		std::stringstream lineStream(line);
+		// Find tag
+		std::getline(lineStream, tag, '=');
+		// Check what tag is it
+		if (tag == INPUT_COUNT_TARGET_TAG)
+			lineStream >> maxScore;
+		else if (tag == INPUT_PROJECTILE_SPEED_TAG)
+			lineStream >> projectileSpeed;
+		else if (tag == INPUT_GAME_TIME_TAG)
+			lineStream >> maxGameTime;
+		else if (tag == INPUT_SEED_TAG)
+			lineStream >> seed;
+		else if (tag == INPUT_ASTEROID_MAX_SPEED_TAG)
+			lineStream >> asteroidMaxSpeed;
+		else if (tag == INPUT_ASTEROID_MIN_SCALE_TAG)
+			lineStream >> asteroidMinScale;
+		else if (tag == INPUT_ASTEROID_MAX_SCALE_TAG)
+			lineStream >> asteroidMaxScale;
+	}
+	// Check if data format is correct (all data is correctly initialized)
+	if (maxScore <= 0 || projectileSpeed <= 0 || maxGameTime <= 0 ||
+		asteroidMaxSpeed < 0 || asteroidMinScale <= 0 || asteroidMaxScale < asteroidMinScale)
+		throw std::invalid_argument(std::string("invalid format of ") + INPUT_FILE);
+
+	// Initialize actual data
+	GameSimulationConfig config;
+	config.maxScore = maxScore;
+	config.projectileSpeed = projectileSpeed;
+	config.maxGameTime = maxGameTime;
+	config.asteroidMaxSpeed = asteroidMaxSpeed;
+	config.asteroidMinScale = asteroidMinScale;
+	config.asteroidMaxScale = asteroidMaxScale;
+	config.seed = seed;
+	return config;
+}
+
+// Input that aims at the closest target and keeps shooting
+// Used to play headless games
+GameInput GameSimulation::getAutopilotInput() const
+{
+	GameInput input;
+	input.aim = gunship_->getPosition();
+	input.shooting = true;
+
+	auto minDistance = std::numeric_limits<float>::max();
+	for (auto& body : world_->getBodies()) {
+		const auto target = dynamic_cast<Target*>(body.get());
+		if (!target || !target->isAlive() || !target->isActive())
+			continue;
+
+		const auto distance = target->getPosition().distanceSquared(gunship_->getPosition());
+		if (distance < minDistance) {
+			minDistance = distance;
+			input.aim = target->getPosition();
+		}
+	}
+	return input;
+}
+
+// One step in time: applies input, steps physics and counts game time
+void GameSimulation::step(const float dT)
+{
+	TRACE_SCOPE("GameSimulation::step");
+	ALLOCATION_SCOPE("Simulation");
+
+	gunship_->lookAt(input_.aim);
+	gunship_->accelerate(input_.axis);
+	if (input_.shooting)
+		gunship_->startShooting();
+	else
+		gunship_->stopShooting();
+
+	// Bodies far from the screen and the gunship step less often
+	auto focus = Rect(config_.origin, config_.size);
+	focus.merge(Rect(gunship_->getPosition(), Size::ZERO));
+	const auto margin = PHYS_LOD_FOCUS_MARGIN * config_.size;
+	world_->setFocus(Rect(focus.origin - Vec2(margin.width, margin.height), focus.size + margin * 2));
+
+	world_->step(dT);
+
+	if (!playing_)
+		return;
+
+	elapsedTime_ += dT;
+	while (playing_ && elapsedTime_ >= gameTime_ + 1)
+		incrementGameTime();
+}
+
+// Play with autopilot until game is over
+// Returns number of steps
+unsigned int GameSimulation::run(const float dT)
+{
+	unsigned int steps = 0;
+	while (playing_) {
+		setInput(getAutopilotInput());
+		step(dT);
+		++steps;
+	}
+	return steps;
+}
+
+// Handle target destruction
+void GameSimulation::onGameObjectBeginDestroy(GameObject* sender)
+{
+	if (!playing_)
+		return;
+
+	const auto target = dynamic_cast<Target*>(sender);
+	if (!target)
+		return;
+
+	++score_;
+	if (listener_)
+		listener_->onScoreChanged(score_);
+
+	// Check for win
+	if (score_ >= config_.maxScore)
+		endGame();
+}
+
+// Increment game time by one second
+void GameSimulation::incrementGameTime()
+{
+	++gameTime_;
+	if (listener_)
+		listener_->onGameTimeChanged(gameTime_);
+
+	// Check for loss
+	if (gameTime_ >= config_.maxGameTime)
+		endGame();
+}
+
+// Stop the game and inform listener, does nothing if game is already over
+void GameSimulation::endGame()
+{
+	if (!playing_)
+		return;
+	playing_ = false;
+	if (listener_)
+		listener_->onGameOver(isWin());
+}
+
+// Create edge, gunship and asteroids
+void GameSimulation::createLevel(Scene* scene)
+{
+	const auto& origin = config_.origin;
+	const auto& size = config_.size;
+	const auto center = origin + size / 2;
+
+	// Create edge around screen
+	auto edgeBody = std::make_unique<PhysBody>(center);
+	edgeBody->addCollider(std::make_unique<PhysBoxCollider>(Vec2(0, (size.height + EDGE_WIDTH) / 2), Size(size.width, EDGE_WIDTH), EDGE_BITMASKS));  // top
+	edgeBody->addCollider(std::make_unique<PhysBoxCollider>(Vec2(0, -(size.height + EDGE_WIDTH) / 2), Size(size.width, EDGE_WIDTH), EDGE_BITMASKS)); // bottom
+	edgeBody->addCollider(std::make_unique<PhysBoxCollider>(Vec2((size.width + EDGE_WIDTH) / 2, 0), Size(EDGE_WIDTH, size.height), EDGE_BITMASKS));  // right
+	edgeBody->addCollider(std::make_unique<PhysBoxCollider>(Vec2(-(size.width + EDGE_WIDTH) / 2, 0), Size(EDGE_WIDTH, size.height), EDGE_BITMASKS)); // left
+	world_->addBody(std::move(edgeBody));
+
+	// Create a gunship in the center of the screen
+	auto gunship = std::make_unique<Gunship>(center, config_.projectileSpeed, GUNSHIP_ACCELERATION * size.width);
+	gunship_ = gunship.get(); // save pointer for easy access
+	if (scene)
+		gunship->addToScene(scene, Z_LEVEL_GUNSHIP); // add cocos2d node to scene
+	world_->addBody(std::move(gunship)); // PhysWorld controls memory
+
+	// Sizes of sprites come from the manifest, their images aren't read
+	const auto gunshipSize = SpriteManifest::get(GUNSHIP_SPRITE).getSize();
+	const auto asteroidSize = SpriteManifest::get(ASTEROID_SPRITE).getSize();
+	const auto maxAsteroidSize = asteroidSize * config_.asteroidMaxScale;
+
+	// Rescale asteroids if too many of them have to be on the screen
+	const auto square = size.width * size.height;
+	auto cellSide = std::sqrt(square * ASTEROIDS_SPARCITY / config_.maxScore);
+	if (cellSide > maxAsteroidSize.width) cellSide = maxAsteroidSize.width; // we don't want cells to be too big with fewer asteroids
+	const unsigned int nX = std::floor(size.width / cellSide) + 1;
+	const unsigned int nY = std::floor(size.height / cellSide) + 1;
+	cellSide = std::min(size.width / nX, size.height / nY);
+	const auto extraScale = cellSide / maxAsteroidSize.width;
+
+	// Create cells where asteroids can be placed
+	const auto nCells = nX * nY;
+	std::vector<unsigned int> cellIndices(nCells);
+	std::iota(cellIndices.begin(), cellIndices.end(), 0);
+	auto& random = world_->getRandom();
+	random.shuffle(cellIndices.begin(), cellIndices.end()); // shuffle indices
+	// Create all asteroids in random positions with random speeds and scales
+	unsigned int placed = 0;
+	for(unsigned int i = 0; i < nCells && placed < config_.maxScore; ++i) {
+		const auto column = cellIndices[i] % nX;
+		const auto row = cellIndices[i] / nX;
+		const auto cellCenter = origin + (Vec2(column, row) + Vec2(0.5, 0.5)) * cellSide;
+
+		// Check if cell is ok (not near center)
+		if (std::abs(center.x - cellCenter.x) < cellSide / 2 + gunshipSize.width / 2 &&
+			std::abs(center.y - cellCenter.y) < cellSide / 2 + gunshipSize.height / 2)
+			continue;
+
+		auto const relativeScale = (config_.asteroidMinScale + random.next_0_1() * (config_.asteroidMaxScale - config_.asteroidMinScale));
+		auto scale = relativeScale * extraScale;
+		const auto asteroidScaledSize = asteroidSize * scale;
+		auto position = cellCenter + Vec2((cellSide - asteroidScaledSize.width) * random.next_minus1_1(), (cellSide - asteroidScaledSize.height) * random.next_minus1_1()) / 2;
+		auto speed = Vec2::ONE.rotateByAngle(Vec2::ZERO, random.next_0_1() * CC_DEGREES_TO_RADIANS(360)) // random direction
+			* random.next_0_1() * config_.asteroidMaxSpeed * size.width / (relativeScale * relativeScale);  // random magnitude
+		std::unique_ptr<PhysMovement> movement;
+		Color3B color;
+		if (random.next_0_1() > 0.5) {
+			movement = std::make_unique<PhysMovement>(speed);
+			color = Color3B::WHITE;
+		}
+		else {
+			auto angularSpeed = random.next_minus1_1() * CC_DEGREES_TO_RADIANS(ASTEROID_MAX_ANGULAR_SPEED);
+			auto curveTime = ASTEROID_MIN_CURVE_TIME + random.next_0_1() * (ASTEROID_MAX_CURVE_TIME - ASTEROID_MIN_CURVE_TIME);
+			movement = std::make_unique<PhysLeftRightMovement>(speed, angularSpeed, curveTime);
+			color = ASTEROIDS_CURVED_COLOR;
+		}
+		auto asteroid = std::make_unique<Asteroid>(position, std::move(movement), scale, color);
+		asteroid->addListener(this); // start listening to target events
+		if (scene)
+			asteroid->addToScene(scene, Z_LEVEL_TARGET); // add cocos2d node to scene
+		world_->addBody(std::move(asteroid));
+		++placed;
+	}
+
+	// Create laser balls before the game starts, so that shooting doesn't create them
+	gunship_->prewarmLaserBalls(LASER_BALLS_PREWARM);
+}
+
+// Constructor
+// scene can be nullptr for headless games
+GameSimulation::GameSimulation(const GameSimulationConfig& config, Scene* scene) : config_(config)
+{
+	if (config_.maxScore == 0 || config_.projectileSpeed <= 0 || config_.maxGameTime == 0 ||
+		config_.asteroidMaxSpeed < 0 || config_.asteroidMinScale <= 0 || config_.asteroidMaxScale < config_.asteroidMinScale)
+		throw std::invalid_argument("invalid game simulation config");
+
+	// Create physics world
+	// Each world has its own random numbers, so simulations don't affect each other
+	world_ = std::make_unique<PhysWorld>(config_.origin - PARTITIONS_OUTSIDE_OFFSET * config_.size, config_.size * (1 + 2 * PARTITIONS_OUTSIDE_OFFSET), config_.seed);
+
+	// Gunship looks to the right until there is some input
+	input_.aim = config_.origin + config_.size / 2 + Vec2(1, 0);
+
+	createLevel(scene);
+}
+// Needed to avoid problems with smart pointers
+GameSimulation::~GameSimulation() = default;
@@ -0,0 +1,139 @@
+#ifndef __GAME_SIMULATION_H__
+#define __GAME_SIMULATION_H__
+
+#include "GameObjectEventListener.h"
+#include "cocos2d.h"
+
+// Forward declarations
+class PhysWorld;
+class Gunship;
+class GameSimulationEventListener;
+
+// Parameters of one game
+struct GameSimulationConfig
+{
+	// Read from input file
+	unsigned int maxScore = 0;
+	float projectileSpeed = 0;
+	unsigned int maxGameTime = 0;
+
+	// Can also be read from input file, defaults are set in constructor
+	float asteroidMaxSpeed; // based on screen width
+	float asteroidMinScale;
+	float asteroidMaxScale;
+
+	// Seed for all random numbers of the game
+	// Same seed and input always give the same game
+	// Can be read from input file, GameScene replaces 0 with a new seed for every game
+	unsigned int seed = 0;
+
+	// Visible area of the game
+	// Headless games use design resolution
+	cocos2d::Vec2 origin = cocos2d::Vec2::ZERO;
+	cocos2d::Size size = cocos2d::Size(1920, 1080);
+
+	// Constructor
+	GameSimulationConfig();
+};
+
+// Player's input for one step
+struct GameInput
+{
+	// Where the gun looks
+	cocos2d::Vec2 aim;
+	// Direction of acceleration
+	cocos2d::Vec2 axis;
+	// True while shooting
+	bool shooting = false;
+};
+
+// Game rules without visuals: physics world, gunship, asteroids, score and game time
+// When created with a scene, all game objects are added to it
+// When created without a scene, no sprites, particles or sounds are created and it can be stepped as fast as needed
+class GameSimulation : public GameObjectEventListener
+{
+public:
+	// Read game parameters from contents of input file
+	static GameSimulationConfig readConfig(const std::string& input);
+
+	// Set player's input, it is used in all following steps
+	void setInput(const GameInput& input) { input_ = input; }
+	// Input that aims at the closest target and keeps shooting
+	// Used to play headless games
+	GameInput getAutopilotInput() const;
+
+	// One step in time: applies input, steps physics and counts game time
+	void step(float dT);
+	// Play with autopilot until game is over
+	// Returns number of steps
+	unsigned int run(float dT);
+	// Stop the game and inform listener, does nothing if game is already over
+	// Called when targets or time run out, or when a replayed recording ends first
+	void endGame();
+
+	// Set listener, can be nullptr
+	void setListener(GameSimulationEventListener* listener) { listener_ = listener; }
+
+	// True if game is on
+	bool isPlaying() const { return playing_; }
+	// True if all targets were destroyed in time
+	bool isWin() const { return score_ >= config_.maxScore; }
+
+	// Return seed of the game
+	unsigned int getSeed() const { return config_.seed; }
+
+	// Return score and game time
+	unsigned int getScore() const { return score_; }
+	unsigned int getMaxScore() const { return config_.maxScore; }
+	unsigned int getGameTime() const { return gameTime_; }
+	unsigned int getMaxGameTime() const { return config_.maxGameTime; }
+	// Time since the start of the game (in seconds), stops when game is over
+	float getElapsedTime() const { return elapsedTime_; }
+
+	// Return physics world and gunship
+	PhysWorld* getWorld() const { return world_.get(); }
+	Gunship* getGunship() const { return gunship_; }
+
+	// Handle target destruction
+	virtual void onGameObjectBeginDestroy(class GameObject* sender) override;
+
+	// Constructor
+	// scene can be nullptr for headless games
+	explicit GameSimulation(const GameSimulationConfig& config, cocos2d::Scene* scene = nullptr);
+	// Needed to avoid problems with smart pointers
+	~GameSimulation();
+
+private:
+	// Create edge, gunship and asteroids
+	void createLevel(cocos2d::Scene* scene);
+
+	// Increment game time by one second
+	void incrementGameTime();
+
+	// Parameters of the game
+	GameSimulationConfig config_;
+
+
+	// Physics
+	std::unique_ptr<PhysWorld> world_;
+
+	// Just a pointer, PhysWorld handles its memory
+	Gunship* gunship_ = nullptr;
+
+	// Current input
+	GameInput input_;
+
+	// True if game is on
+	bool playing_ = true;
+
+	// Game time
+	unsigned int gameTime_ = 0;
+	float elapsedTime_ = 0;
+	// Player's score
+	unsigned int score_ = 0;
+
+	// Listener of game events
+	GameSimulationEventListener* listener_ = nullptr;
+};
+
+#endif // __GAME_SIMULATION_H__
@@ -0,0 +1,18 @@
+#ifndef __GAME_SIMULATION_EVENT_LISTENER_H__
+#define __GAME_SIMULATION_EVENT_LISTENER_H__
+
+// Abstract class that allows handling events of GameSimulation
+class GameSimulationEventListener
+{
+public:
+	// Called when player's score changes
+	virtual void onScoreChanged(unsigned int score) {}
+
+	// Called every second of game time
+	virtual void onGameTimeChanged(unsigned int gameTime) {}
+
+	// Called once when game is over
+	virtual void onGameOver(bool isWin) {}
+};
+
+#endif // __GAME_SIMULATION_EVENT_LISTENER_H__
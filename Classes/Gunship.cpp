@@ -1,10 +1,11 @@
 #include "Gunship.h"
 #include "Physics/Physics.h"
-#include "LaserBall.h"
+#include "EffectQueue.h"
+#include "AudioManager.h"
+#include "ParticleCache.h"
+#include "SpriteManifest.h"
 #include "Definitions.h"
-
-#include "audio/include/SimpleAudioEngine.h"
-using namespace CocosDenshion;
+#include "AllocationTracker.h"
 
 USING_NS_CC;
 
@@ -20,18 +21,22 @@ void Gunship::lookInDirection(const Vec2& direction)
 {
 	if (direction.isZero())
 		return; // Don't do anything
-	gunDirection_ = direction.getNormalized();
+	const auto gunDirection = direction.getNormalized();
+	if (gunDirection == gunDirection_)
+		return;
+	gunDirection_ = gunDirection;
 
-	// Update gun sprite
-	gun_->setPosition(gunDirection_ * gun_->getContentSize().width / 2);
-	gun_->setRotation(-CC_RADIANS_TO_DEGREES(gunDirection_.getAngle()));
+	// Gun sprite is turned with the next frame
+	markDirty();
 }
 
 // Accelerate in direction
 void Gunship::accelerate(const Vec2& direction)
 {
-	getMovement()->setAcceleration(direction.getNormalized() * GUNSHIP_ACCELERATION);
+	getMovement()->setAcceleration(direction.getNormalized() * acceleration_);
 
+	if (!boosters_)
+		return;
 	if (direction.isZero())
 		boosters_->pauseEmissions();
 	else
@@ -49,40 +54,38 @@ void Gunship::stopShooting()
 }
 void Gunship::shoot()
 {
-	if (!sceneNode_)
-		return;
+	ALLOCATION_SCOPE("Shots");
 
 	sinceLastShot_ = 0;
 	++shotCount_;
 
-	const auto laserLocation = getPosition() + gunDirection_ * gun_->getContentSize().width * LASER_BALL_SPAWN_DISTANCE;
+	const auto laserLocation = getPosition() + gunDirection_ * gunSize_.width * LASER_BALL_SPAWN_DISTANCE;
 
 	// "Power" shot is a shot with different curved movement
 	const auto isPowerShot = shotCount_ % POWER_SHOT_INDEX == 0;
 
 	// Play sound
-	SimpleAudioEngine::getInstance()->playEffect(!isPowerShot ? SHOOT_NORMAL_SOUND_EFFECT : SHOOT_POWERFUL_SOUND_EFFECT);
+	if (sceneNode_)
+		AudioManager::getInstance()->playEffect(!isPowerShot ? SHOOT_NORMAL_SOUND_EFFECT : SHOOT_POWERFUL_SOUND_EFFECT);
 
 	// Spawns new or takes from pool
-	auto laserBall = spawnLaserBall(laserLocation);
+	auto laserBall = getLaserBallPool().spawn(laserLocation);
 	auto laserSpeed = gunDirection_ * laserSpeed_ * (!isPowerShot ? 1 : POWER_SHOT_SPEED_K);
-	laserBall->setMovement(!isPowerShot ?
-		std::make_unique<PhysMovement>(laserSpeed) :
-		std::make_unique<PhysLeftRightMovement>(laserSpeed, CC_DEGREES_TO_RADIANS(POWER_SHOT_ANGULAR_SPEED), POWER_SHOT_CURVE_DURATION, shotCount_ % (2 * POWER_SHOT_INDEX) == 0 ? 1 : -1));
+	if (!isPowerShot)
+		laserBall->setStraightMovement(laserSpeed);
+	else
+		laserBall->setCurvedMovement(laserSpeed, CC_DEGREES_TO_RADIANS(POWER_SHOT_ANGULAR_SPEED), POWER_SHOT_CURVE_DURATION, shotCount_ % (2 * POWER_SHOT_INDEX) == 0 ? 1 : -1);
 	laserBall->setColor(!isPowerShot ? LASER_BALL_NORMAL_COLOR : LASER_BALL_POWERFUL_COLOR);
 }
 
 // Called on hits
 void Gunship::onHit(const PhysContact& contact)
 {
-	// Play sound
-	SimpleAudioEngine::getInstance()->playEffect(GUNSHIP_BOUNCE_SOUND_EFFECT);
-
 	if (sceneNode_) {
-		// Create particle
-		auto sparks = ParticleSystemQuad::create(GUNSHIP_BOUNCED_PARTICLES);
-		sparks->setPosition(getPosition() + contact.getDirectionFrom(this) * hull_->getContentSize().width / 2);
-		sceneNode_->addChild(sparks, rootNode_->getLocalZOrder());
+		// Play sound and create particle, both are merged with other hits of this frame
+		const auto hitPosition = getPosition() + contact.getDirectionFrom(this) * hullSize_.width / 2;
+		effects_->addSound(GUNSHIP_BOUNCE_SOUND_EFFECT, hitPosition);
+		effects_->addBurst(GUNSHIP_BOUNCED_PARTICLES, rootNode_->getLocalZOrder(), hitPosition);
 	}
 
 	GameObject::onHit(contact);
@@ -98,65 +101,71 @@ void Gunship::step(const float dT)
 		shoot();
 }
 
-// Handle event from other game object
-// Find a deactivated projectile and add it to pool
-void Gunship::onGameObjectDeactivated(GameObject* sender)
+// Move sprites
+// Gun is also turned here, once per frame instead of every step
+void Gunship::moveNodes(const Vec2& pos)
 {
-	const auto laserBall = dynamic_cast<LaserBall*>(sender);
-	if (laserBall)
-		laserBallsPool_.push(laserBall);
-}
+	GameObject::moveNodes(pos);
 
-// Pool a laser ball or create a new one
-LaserBall* Gunship::spawnLaserBall(const Vec2& pos)
-{
-	LaserBall* laserBall = nullptr;
-
-	// Pool
-	if(!laserBallsPool_.empty()) {
-		laserBall = laserBallsPool_.front();
-		laserBallsPool_.pop();
-		laserBall->setPosition(pos);
-		laserBall->setActive(true);
-		laserBall->reset(); // reset life time
-	}
-	// Create new
-	else {
-		auto newLaserBall = std::make_unique<LaserBall>(pos);
-		newLaserBall->addToScene(sceneNode_, Z_LEVEL_PROJECTILE);
-		newLaserBall->addListener(this);
-		laserBall = newLaserBall.get();
-		getWorld()->addBody(std::move(newLaserBall));
+	if (gun_) {
+		gun_->setPosition(gunDirection_ * gunSize_.width / 2);
+		gun_->setRotation(-CC_RADIANS_TO_DEGREES(gunDirection_.getAngle()));
 	}
-
-	return laserBall;
 }
 
-// Constructor
-Gunship::Gunship(const Vec2& pos, const float laserSpeed) : GameObject(pos, GUNSHIP_MASS, GUNSHIP_BOUNCINESS)
+// Create laser balls in advance, should be called after gunship is added to the world (and scene)
+void Gunship::prewarmLaserBalls(const unsigned int count)
 {
-	if (laserSpeed <= 0)
-		throw std::invalid_argument("laser speed should be > 0");
+	getLaserBallPool().prewarm(count);
+}
+// Return pool of laser balls, it is created on first use
+ObjectPool<LaserBall>& Gunship::getLaserBallPool()
+{
+	if (!laserBallPool_)
+		laserBallPool_ = std::make_unique<ObjectPool<LaserBall>>(getWorld(), sceneNode_, Z_LEVEL_PROJECTILE, [](const Vec2& pos) {
+			return std::make_unique<LaserBall>(pos);
+		});
+	return *laserBallPool_;
+}
 
-	laserSpeed_ = laserSpeed;
+// Create sprites and particles
+void Gunship::addToScene(Scene* scene, const int zLevel)
+{
+	GameObject::addToScene(scene, zLevel);
 
-	hull_ = Sprite::create();
-	hull_->initWithFile(GUNSHIP_SPRITE);
+	hull_ = SpriteManifest::createSprite(GUNSHIP_SPRITE);
 	hull_->setPosition(0, 0);
 	rootNode_->addChild(hull_, 0);
 
-	gun_ = Sprite::create();
-	gun_->initWithFile(GUN_SPRITE);
-	lookInDirection(Vec2(1, 0)); // Initial gun direction
+	gun_ = SpriteManifest::createSprite(GUN_SPRITE);
 	rootNode_->addChild(gun_, -1); // gun is below the hull
+	markDirty(); // turn the gun sprite
 
 	// Create particle
-	boosters_ = ParticleSystemQuad::create(GUNSHIP_BOOSTERS_PARTICLES); 
+	boosters_ = ParticleCache::getInstance()->create(GUNSHIP_BOOSTERS_PARTICLES); 
 	boosters_->setPosition(Vec2::ZERO);
 	boosters_->pauseEmissions();
 	rootNode_->addChild(boosters_, -2);
+}
+
+// Constructor
+Gunship::Gunship(const Vec2& pos, const float laserSpeed, const float acceleration) : GameObject(pos, GUNSHIP_MASS, GUNSHIP_BOUNCINESS)
+{
+	if (laserSpeed <= 0)
+		throw std::invalid_argument("laser speed should be > 0");
+	if (acceleration < 0)
+		throw std::invalid_argument("acceleration should be >= 0");
+
+	laserSpeed_ = laserSpeed;
+	acceleration_ = acceleration;
+
+	const auto& hull = SpriteManifest::get(GUNSHIP_SPRITE);
+	hullSize_ = hull.getSize();
+	gunSize_ = SpriteManifest::get(GUN_SPRITE).getSize();
+
+	lookInDirection(Vec2(1, 0)); // Initial gun direction
 
-	addCollider(std::make_unique<PhysCircleCollider>(hull_->getContentSize().width / 2, GUNSHIP_BITMASKS));
+	addCollider(std::make_unique<PhysCircleCollider>(hull.radius, GUNSHIP_BITMASKS));
 	setMovement(std::make_unique<PhysMovement>());
 
 	sinceLastShot_ = SHOT_INTERVAL;
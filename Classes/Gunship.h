@@ -2,14 +2,12 @@
 #define __GUNSHIP_H__
 
 #include "GameObject.h"
-#include "GameObjectEventListener.h"
+#include "ObjectPool.h"
+#include "LaserBall.h"
 #include "cocos2d.h"
 
-// Forward declarations
-class LaserBall;
-
 // A gunship that can shoot projectiles
-class Gunship : public GameObject, GameObjectEventListener
+class Gunship : public GameObject
 {
 public:
 	// Change where the gun 'looks'
@@ -30,15 +28,22 @@ public:
 	// Spawn projectiles
 	virtual void step(float dT) override;
 
-	// Handle event from other game object
-	// Find a deactivated projectile and add it to pool
-	virtual void onGameObjectDeactivated(GameObject* sender) override;
+	// Create laser balls in advance, should be called after gunship is added to the world (and scene)
+	void prewarmLaserBalls(unsigned int count);
+	// Return pool of laser balls, it is created on first use
+	ObjectPool<LaserBall>& getLaserBallPool();
+
+	// Create sprites and particles
+	virtual void addToScene(cocos2d::Scene* scene, int zLevel) override;
+
+protected:
+	// Move sprites and turn the gun
+	virtual void moveNodes(const cocos2d::Vec2& pos) override;
 
-	// Pool a laser ball or create a new one
-	LaserBall* spawnLaserBall(const cocos2d::Vec2& pos);
+public:
 
 	// Constructor
-	explicit Gunship(const cocos2d::Vec2& pos = cocos2d::Vec2::ZERO, float laserSpeed = 100);
+	explicit Gunship(const cocos2d::Vec2& pos = cocos2d::Vec2::ZERO, float laserSpeed = 100, float acceleration = 100);
 	// Important for cleaning memory using base class pointer
 	virtual ~Gunship();
 
@@ -47,8 +52,15 @@ private:
 	cocos2d::Vec2 gunDirection_;
 
 	// Sprites
-	cocos2d::Sprite* hull_;
-	cocos2d::Sprite* gun_;
+	cocos2d::Sprite* hull_ = nullptr;
+	cocos2d::Sprite* gun_ = nullptr;
+
+	// Sizes of sprites, known even without a scene
+	cocos2d::Size hullSize_;
+	cocos2d::Size gunSize_;
+
+	// For movement
+	float acceleration_;
 
 	// For shooting
 	float laserSpeed_;
@@ -57,10 +69,10 @@ private:
 	unsigned int shotCount_ = 0;
 
 	// Pool of laser balls
-	std::queue<LaserBall*> laserBallsPool_;
+	std::unique_ptr<ObjectPool<LaserBall>> laserBallPool_;
 
 	// Particles for boosters
-	cocos2d::ParticleSystemQuad* boosters_;
+	cocos2d::ParticleSystemQuad* boosters_ = nullptr;
 };
 
 #endif // __GUNSHIP_H__
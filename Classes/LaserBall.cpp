@@ -1,81 +1,116 @@
 #include "LaserBall.h"
 #include "Physics/Physics.h"
 #include "Target.h"
+#include "EffectQueue.h"
+#include "TrailBatch.h"
+#include "SpriteManifest.h"
 #include "Definitions.h"
 
-#include "audio/include/SimpleAudioEngine.h"
-using namespace CocosDenshion;
-
 USING_NS_CC;
 
 // Set the color of laser ball
 void LaserBall::setColor(const Color3B& color)
 {
-	laserBall_->setColor(color);
-	tail_->setStartColor(Color4F(color));
+	color_ = color;
+
+	if (laserBall_)
+		laserBall_->setColor(color_);
+	if (trail_)
+		trail_->setEmitterColor(trailEmitter_, Color4F(color_));
+}
+
+// Start moving straight or on a curve
+// Both movements are preallocated and reset in place, so pooled laser balls don't allocate on shots
+void LaserBall::setStraightMovement(const Vec2& speed)
+{
+	straightMovement_->reset(speed);
+	useMovement(straightMovement_);
+}
+void LaserBall::setCurvedMovement(const Vec2& speed, const float& angularSpeed, const float& curveTime, const float& curveK)
+{
+	curvedMovement_->reset(speed, angularSpeed, curveTime, curveK);
+	useMovement(curvedMovement_);
+}
+
+// Give one of preallocated movements to the body, the other one is kept as spare
+void LaserBall::useMovement(PhysMovement* movement)
+{
+	if (getMovement() != movement)
+		spareMovement_ = setMovement(std::move(spareMovement_));
 }
 
 // Disable particles
 void LaserBall::setActive(const bool active)
 {
-	laserBall_->setVisible(active);
-	if (active)
-		tail_->resumeEmissions();
-	else
-		tail_->pauseEmissions();
+	if (laserBall_)
+		laserBall_->setVisible(active);
+	if (trail_)
+		trail_->setEmitterActive(trailEmitter_, active);
 
 	Projectile::setActive(active);
 }
 
-// Update particle position
-void LaserBall::setPosition(const cocos2d::Vec2& pos)
+// Move sprite and tail
+// Sprite also fades out with life time here, once per frame instead of every step
+void LaserBall::moveNodes(const cocos2d::Vec2& pos)
 {
-	Projectile::setPosition(pos);
-	
+	Projectile::moveNodes(pos);
+
+	if (laserBall_)
+		laserBall_->setOpacity(std::pow(std::max(LASER_BALL_LIFE_TIME - getLifeTime(), 0.0f) / LASER_BALL_LIFE_TIME, 0.3) * LASER_BALL_START_OPACITY);
+
 	// Update tail position
-	if(tail_) tail_->setSourcePosition(pos);
+	if (trail_)
+		trail_->setEmitterPosition(trailEmitter_, pos);
 }
 
-// Create tail
+// Create sprite and tail
 void LaserBall::addToScene(cocos2d::Scene* scene, const int zLevel)
 {
 	Projectile::addToScene(scene, zLevel);
 
-	if (sceneNode_) {
-		// Create particle tail
-		tail_ = ParticleSystemQuad::create(LASER_BALL_TRAIL_PARTICLES);
-		tail_->setSourcePosition(getPosition());
-		sceneNode_->addChild(tail_, zLevel);
-	}
+	laserBall_ = SpriteManifest::createSprite(LASER_BALL_SPRITE);
+	laserBall_->setPosition(Vec2::ZERO);
+	laserBall_->setColor(color_);
+	laserBall_->setVisible(isActive());
+	rootNode_->addChild(laserBall_);
+
+	// Create particle tail
+	trail_ = TrailBatch::getFor(scene, LASER_BALL_TRAIL_PARTICLES, zLevel, LASER_BALL_TRAIL_MAX_EMITTERS);
+	trailEmitter_ = trail_->addEmitter(getPosition(), Color4F(color_));
+	trail_->setEmitterActive(trailEmitter_, isActive());
 }
 
-// Constructors
-LaserBall::LaserBall(const Vec2& pos, const Vec2& speed) : LaserBall(pos, std::make_unique<PhysMovement>(speed)) {}
-LaserBall::LaserBall(const Vec2& pos, std::unique_ptr<PhysMovement> movement) : Projectile(pos, LASER_BALL_MASS, LASER_BALL_BOUNCINESS)
+// Constructor
+LaserBall::LaserBall(const Vec2& pos, const Vec2& speed) : Projectile(pos, LASER_BALL_MASS, LASER_BALL_BOUNCINESS), color_(LASER_BALL_NORMAL_COLOR)
 {
-	laserBall_ = Sprite::create();
-	laserBall_->initWithFile(LASER_BALL_SPRITE);
-	laserBall_->setPosition(Vec2::ZERO);
-	rootNode_->addChild(laserBall_);
+	const auto& sprite = SpriteManifest::get(LASER_BALL_SPRITE);
+	size_ = sprite.getSize();
+
+	addCollider(std::make_unique<PhysCircleCollider>(sprite.radius, LASER_BALL_BITMASKS));
 
-	addCollider(std::make_unique<PhysCircleCollider>(laserBall_->getContentSize().width / 2, LASER_BALL_BITMASKS));
-	setMovement(std::move(movement));
+	auto straightMovement = std::make_unique<PhysMovement>(speed);
+	straightMovement_ = straightMovement.get();
+	setMovement(std::move(straightMovement));
+	auto curvedMovement = std::make_unique<PhysLeftRightMovement>(speed, 0, POWER_SHOT_CURVE_DURATION);
+	curvedMovement_ = curvedMovement.get();
+	spareMovement_ = std::move(curvedMovement);
 }
 // Important for cleaning memory using base class pointer
-LaserBall::~LaserBall() = default;
+LaserBall::~LaserBall()
+{
+	if (trail_)
+		trail_->removeEmitter(trailEmitter_);
+}
 
 // Called on hits
 void LaserBall::onHit(const PhysContact& contact)
 {
-	// Play sound
-	SimpleAudioEngine::getInstance()->playEffect(LASER_BOUNCE_SOUND_EFFECT);
-
 	if (sceneNode_) {
-		// Create particle
-		auto sparks = ParticleSystemQuad::create(LASER_BALL_BOUNCED_PARTICLES);
-		sparks->setPosition(getPosition() + contact.getDirectionFrom(this) * laserBall_->getContentSize().width / 2);
-		sparks->setStartColor(tail_->getStartColor());
-		sceneNode_->addChild(sparks, rootNode_->getLocalZOrder());
+		// Play sound and create particle, both are merged with other hits of this frame
+		const auto hitPosition = getPosition() + contact.getDirectionFrom(this) * size_.width / 2;
+		effects_->addSound(LASER_BOUNCE_SOUND_EFFECT, hitPosition);
+		effects_->addBurst(LASER_BALL_BOUNCED_PARTICLES, rootNode_->getLocalZOrder(), hitPosition, Color4F(color_));
 	}
 
 	Projectile::onHit(contact);
@@ -89,8 +124,6 @@ void LaserBall::step(const float dT)
 	if (getLifeTime() > LASER_BALL_LIFE_TIME)
 		// destroy();
 		setActive(false);
-	else
-		laserBall_->setOpacity(std::pow((LASER_BALL_LIFE_TIME - getLifeTime()) / LASER_BALL_LIFE_TIME, 0.3) * LASER_BALL_START_OPACITY);
 }
 
 // Called on hitting (overlapping) a Target
@@ -100,15 +133,10 @@ void LaserBall::onHitTarget(Target* target, const Vec2& toTarget)
 	if (!target || !target->isAlive() || !target->isActive())
 		return;
 
-	// Play sound
-	SimpleAudioEngine::getInstance()->playEffect(LASER_HIT_SOUND_EFFECT);
-
 	if (sceneNode_) {
-		// Create particle
-		auto sparks = ParticleSystemQuad::create(LASER_BALL_DESTROYED_PARTICLES);
-		sparks->setPosition(getPosition());
-		sparks->setStartColor(tail_->getStartColor());
-		sceneNode_->addChild(sparks, rootNode_->getLocalZOrder());
+		// Play sound and create particle, both are merged with other hits of this frame
+		effects_->addSound(LASER_HIT_SOUND_EFFECT, getPosition());
+		effects_->addBurst(LASER_BALL_DESTROYED_PARTICLES, rootNode_->getLocalZOrder(), getPosition(), Color4F(color_));
 	}
 
 	target->onBeingHit(this, -toTarget);
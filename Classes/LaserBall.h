@@ -2,27 +2,31 @@
 #define __LASER_BALL_H__
 
 #include "Projectile.h"
+#include "Physics/PhysPool.h"
 #include "cocos2d.h"
 
 // A laser ball projectile
 class LaserBall : public Projectile
 {
+	PHYS_POOLED(LaserBall)
+
 public:
 	// Set the color of laser ball
 	void setColor(const cocos2d::Color3B& color);
 
+	// Start moving straight or on a curve
+	// Both movements are preallocated and reset in place, so pooled laser balls don't allocate on shots
+	void setStraightMovement(const cocos2d::Vec2& speed);
+	void setCurvedMovement(const cocos2d::Vec2& speed, const float& angularSpeed, const float& curveTime, const float& curveK);
+
 	// Disable particles
 	virtual void setActive(bool active) override;
 
-	// Update particle position
-	virtual void setPosition(const cocos2d::Vec2& pos) override;
-
-	// Create tail
+	// Create sprite and tail
 	virtual void addToScene(cocos2d::Scene* scene, int zLevel) override;
 
-	// Constructors
+	// Constructor
 	explicit LaserBall(const cocos2d::Vec2& pos, const cocos2d::Vec2& speed = cocos2d::Vec2::ZERO);
-	LaserBall(const cocos2d::Vec2& pos, std::unique_ptr<PhysMovement> movement);
 	// Important for cleaning memory using base class pointer
 	virtual ~LaserBall();
 
@@ -36,9 +40,29 @@ protected:
 	// Called on hitting (overlapping) a Target
 	virtual void onHitTarget(class Target* target, const cocos2d::Vec2& toTarget) override;
 
+	// Move sprite and tail
+	virtual void moveNodes(const cocos2d::Vec2& pos) override;
+
 private:
-	cocos2d::Sprite* laserBall_;
-	cocos2d::ParticleSystemQuad* tail_;
+	// Give one of preallocated movements to the body, the other one is kept as spare
+	void useMovement(PhysMovement* movement);
+
+private:
+	// Preallocated movements, one is owned by the body and the other one by spareMovement_
+	PhysMovement* straightMovement_ = nullptr;
+	class PhysLeftRightMovement* curvedMovement_ = nullptr;
+	std::unique_ptr<PhysMovement> spareMovement_;
+
+	cocos2d::Sprite* laserBall_ = nullptr;
+	// Tail is an emitter of the trail batch shared by all laser balls
+	class TrailBatch* trail_ = nullptr;
+	unsigned int trailEmitter_ = 0;
+
+	// Size of the sprite, known even without a scene
+	cocos2d::Size size_;
+
+	// Color of the sprite and tail
+	cocos2d::Color3B color_;
 };
 
 #endif // __LASER_BALL_H__
@@ -1,9 +1,10 @@
 #include "MenuScene.h"
 #include "GameScene.h"
+#include "AudioManager.h"
+#include "ParticleCache.h"
 #include "Definitions.h"
-
-#include "audio/include/SimpleAudioEngine.h"
-using namespace CocosDenshion;
+#include "Trace.h"
+#include "AllocationTracker.h"
 
 USING_NS_CC;
 
@@ -25,7 +26,7 @@ bool MenuScene::init()
 	this->addChild(backSprite, Z_LEVEL_BACKGROUND);
 
 	// Galaxy particles
-	auto galaxy = ParticleSystemQuad::create(STARS_PARTICLES);
+	auto galaxy = ParticleCache::getInstance()->create(STARS_PARTICLES);
 	galaxy->setPosition(CENTER);
 	this->addChild(galaxy, Z_LEVEL_STARS);
 
@@ -60,7 +61,9 @@ bool MenuScene::init()
 // Start the game
 void MenuScene::menuPlayCallback(cocos2d::Ref* sender)
 {
-	SimpleAudioEngine::getInstance()->playEffect(CLICK_SOUND_EFFECT);
+	AudioManager::getInstance()->playEffect(CLICK_SOUND_EFFECT);
+	TRACE_SCOPE("Transition to GameScene");
+	ALLOCATION_SCOPE("Scenes");
 	const auto scene = GameScene::createScene();
 	Director::getInstance()->replaceScene(SCENE_TRANSITION(scene));
 }
@@ -68,6 +71,6 @@ void MenuScene::menuPlayCallback(cocos2d::Ref* sender)
 // Exits the game
 void MenuScene::menuExitCallback(cocos2d::Ref* sender)
 {
-	SimpleAudioEngine::getInstance()->playEffect(CLICK_SOUND_EFFECT);
+	AudioManager::getInstance()->playEffect(CLICK_SOUND_EFFECT);
 	Director::getInstance()->end();
 }
@@ -0,0 +1,120 @@
+#ifndef __OBJECT_POOL_H__
+#define __OBJECT_POOL_H__
+
+#include "GameObject.h"
+#include "GameObjectEventListener.h"
+#include "Physics/PhysWorld.h"
+#include "cocos2d.h"
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <memory>
+
+// Pool of game objects of one type, they are deactivated instead of destroyed and spawned again later
+// Objects are owned by the world, pool only keeps pointers to inactive ones
+// Objects return to the pool automatically when deactivated, destroyed objects are forgotten
+// Pool must outlive its objects or be destroyed together with the world
+template<typename T>
+class ObjectPool : public GameObjectEventListener
+{
+public:
+	// Creates a new object at position
+	using Factory = std::function<std::unique_ptr<T>(const cocos2d::Vec2&)>;
+
+	// Create objects in advance (e.g. while scene is loading), so that spawning doesn't create them mid-game
+	// Created objects are inactive
+	void prewarm(const unsigned int count)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+			create(cocos2d::Vec2::ZERO)->setActive(false); // returns it to the pool
+	}
+
+	// Take an inactive object or create a new one, it is active at position
+	T* spawn(const cocos2d::Vec2& pos)
+	{
+		T* object;
+		if (!free_.empty()) {
+			object = free_.front();
+			free_.pop_front();
+			object->setPosition(pos);
+			object->setActive(true);
+			object->reset(); // reset life time
+		}
+		else
+			object = create(pos);
+
+		++activeCount_;
+		highWaterMark_ = std::max(highWaterMark_, activeCount_);
+		return object;
+	}
+
+	// Return number of objects ever created, active objects and most objects active at once
+	unsigned int getCreatedCount() const { return createdCount_; }
+	unsigned int getActiveCount() const { return activeCount_; }
+	unsigned int getHighWaterMark() const { return highWaterMark_; }
+	// Return number of inactive objects ready to be spawned
+	unsigned int getFreeCount() const { return static_cast<unsigned int>(free_.size()); }
+
+	// Return deactivated object to the pool
+	virtual void onGameObjectDeactivated(GameObject* sender) override
+	{
+		free_.push_back(static_cast<T*>(sender));
+		if (activeCount_ > 0)
+			--activeCount_;
+	}
+	// Forget destroyed object
+	virtual void onGameObjectBeginDestroy(GameObject* sender) override
+	{
+		const auto foundIt = std::find(free_.begin(), free_.end(), static_cast<T*>(sender));
+		if (foundIt != free_.end())
+			free_.erase(foundIt);
+		else if (activeCount_ > 0)
+			--activeCount_;
+	}
+
+private:
+	// Create a new object, add it to the world and scene (if any) and start listening to it
+	T* create(const cocos2d::Vec2& pos)
+	{
+		auto newObject = factory_(pos);
+		if (scene_)
+			newObject->addToScene(scene_, zLevel_);
+		newObject->addListener(this);
+		const auto object = newObject.get();
+		world_->addBody(std::move(newObject));
+		++createdCount_;
+		return object;
+	}
+
+public:
+	// Constructor
+	// scene can be nullptr for headless games
+	ObjectPool(PhysWorld* world, cocos2d::Scene* scene, const int zLevel, Factory factory)
+		: world_(world), scene_(scene), zLevel_(zLevel), factory_(std::move(factory))
+	{
+		if (!world_)
+			throw std::invalid_argument("world can't be nullptr");
+		if (!factory_)
+			throw std::invalid_argument("factory can't be empty");
+	}
+
+	ObjectPool(const ObjectPool&) = delete;
+	ObjectPool& operator=(const ObjectPool&) = delete;
+
+private:
+	// Where objects are created
+	PhysWorld* world_;
+	cocos2d::Scene* scene_;
+	int zLevel_;
+	Factory factory_;
+
+	// Inactive objects, the oldest is spawned first
+	std::deque<T*> free_;
+
+	// Stats
+	unsigned int createdCount_ = 0;
+	unsigned int activeCount_ = 0;
+	unsigned int highWaterMark_ = 0;
+};
+
+#endif // __OBJECT_POOL_H__
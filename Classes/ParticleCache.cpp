@@ -0,0 +1,28 @@
+#include "ParticleCache.h"
+
+USING_NS_CC;
+
+// Return cache of the game
+ParticleCache* ParticleCache::getInstance()
+{
+	static ParticleCache instance;
+	return &instance;
+}
+
+// Create particle system of file
+ParticleSystemQuad* ParticleCache::create(const std::string& file)
+{
+	const auto foundIt = data_.find(file);
+	if (foundIt == data_.end())
+		return ParticleSystemQuad::create(file);
+	return ParticleSystemQuad::create(foundIt->second);
+}
+
+// Initialize particle system (e.g. of a subclass) with file
+bool ParticleCache::init(ParticleSystem* system, const std::string& file)
+{
+	const auto foundIt = data_.find(file);
+	if (foundIt == data_.end())
+		return system->initWithFile(file);
+	return system->initWithDictionary(foundIt->second, "");
+}
@@ -0,0 +1,33 @@
+#ifndef __PARTICLE_CACHE_H__
+#define __PARTICLE_CACHE_H__
+
+#include "cocos2d.h"
+#include <string>
+#include <unordered_map>
+
+// Parsed particle plists, their textures are already in the TextureCache
+// Particle systems created from the cache skip parsing the plist and decoding its texture
+// Filled by AssetPreloader, files that aren't cached are loaded the usual way
+// Main thread only, like the rest of cocos2d
+class ParticleCache
+{
+public:
+	// Return cache of the game
+	static ParticleCache* getInstance();
+
+	// Add parsed plist of file, its texture file name should be the key of a cached texture
+	void add(const std::string& file, cocos2d::ValueMap data) { data_[file] = std::move(data); }
+	// Whether file is cached
+	bool contains(const std::string& file) const { return data_.find(file) != data_.end(); }
+
+	// Create particle system of file
+	cocos2d::ParticleSystemQuad* create(const std::string& file);
+	// Initialize particle system (e.g. of a subclass) with file
+	bool init(cocos2d::ParticleSystem* system, const std::string& file);
+
+private:
+	// Parsed plists by file
+	std::unordered_map<std::string, cocos2d::ValueMap> data_;
+};
+
+#endif // __PARTICLE_CACHE_H__
@@ -6,13 +6,14 @@
 
 USING_NS_CC;
 
-// Sets the world to inform it of body changes later
+// Sets the world to inform it of body changes later and the id of body in this world
 // Should only be called from PhysWorld directly when adding body
-void PhysBody::setWorld(PhysWorld* world)
+void PhysBody::setWorld(PhysWorld* world, const unsigned int id)
 {
 	if (!world)
 		throw std::invalid_argument("world can't be nullptr");
 	world_ = world;
+	id_ = id;
 }
 
 // Updates position and informs world about it
@@ -62,10 +63,12 @@ void PhysBody::setBounciness(const float& bounciness)
 }
 
 // Set movement
-void PhysBody::setMovement(std::unique_ptr<PhysMovement> movement)
+// Returns previous movement, so that it can be kept and set again later
+std::unique_ptr<PhysMovement> PhysBody::setMovement(std::unique_ptr<PhysMovement> movement)
 {
-	movement_ = std::move(movement);
+	std::swap(movement_, movement);
 	movement_->setBody(this);
+	return movement;
 }
 
 // Set activeness and inform the world
@@ -74,6 +77,7 @@ void PhysBody::setActive(const bool active)
 	if (isActive_ == active)
 		return;
 	isActive_ = active;
+	pendingTime_ = 0; // time of being inactive isn't simulated
 	informWorld();
 }
 
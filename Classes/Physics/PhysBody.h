@@ -14,16 +14,30 @@ class PhysContact;
 // 2) add colliders  |  body->addCollider(std::move(std::make_unique<PhysCollider>(pos, ...)));
 // 3) add movement   |  body->addMovement(std::move(std::make_unique<PhysMovement>(...));
 // 4) add to world   |  world->addBody(std::move(body));
+// Classes declared with PHYS_POOLED (see PhysPool.h) are allocated from their pools, std::make_unique and unique_ptr work as usual
 
 // Basic physics body with colliders, movement_ and other required information
 class PhysBody
 {
 public:
-	// Set the world to inform it of body changes later
+	// For hashing
+	// We hash ids instead of pointers, so that order of bodies in containers doesn't depend on memory addresses
+	// That keeps simulations with the same seed exactly the same
+	struct PhysBodyHasher
+	{
+		std::size_t operator()(const PhysBody* body) const
+		{
+			return std::hash<unsigned int>()(body->id_);
+		}
+	};
+
+	// Set the world to inform it of body changes later and the id of body in this world
 	// Should only be called from PhysWorld directly when adding body
-	void setWorld(PhysWorld* world);
+	void setWorld(PhysWorld* world, unsigned int id);
 	// Return world
 	PhysWorld* getWorld() const { return world_; }
+	// Return id, unique in the world
+	unsigned int getId() const { return id_; }
 
 	// Update position and inform the world about it
 	virtual void setPosition(const cocos2d::Vec2& pos);
@@ -45,7 +59,8 @@ public:
 	const float& getBounciness() const { return bounciness_; }
 
 	// Set/get movement
-	void setMovement(std::unique_ptr<PhysMovement> movement);
+	// Returns previous movement, so that it can be kept and set again later
+	std::unique_ptr<PhysMovement> setMovement(std::unique_ptr<PhysMovement> movement);
 	PhysMovement* getMovement() const { return movement_.get(); }
 
 	// True if there is no movement_
@@ -60,6 +75,29 @@ public:
 	// If it is active and it is not kinematic, it moves
 	virtual void step(float dT);
 
+	// Add time of a world step, returns time since the last step of the body
+	// Should only be called from PhysWorld, which steps far bodies less often with all of that time
+	float addPendingTime(const float dT) { return pendingTime_ += dT; }
+	void clearPendingTime() { pendingTime_ = 0; }
+	// Return time of world steps the body hasn't stepped yet
+	float getPendingTime() const { return pendingTime_; }
+
+	// Columns and rows of world partitions the body can be in, empty if it's in none
+	// Should only be used by PhysWorld, which updates only these partitions when the body moves
+	struct PartitionRange
+	{
+		unsigned int minColumn = 1, minRow = 1;
+		unsigned int maxColumn = 0, maxRow = 0;
+		bool isEmpty() const { return minColumn > maxColumn || minRow > maxRow; }
+	};
+	const PartitionRange& getPartitionRange() const { return partitionRange_; }
+	void setPartitionRange(const PartitionRange& range) { partitionRange_ = range; }
+
+	// True if the body is queued for contact evaluation in the next step
+	// Should only be used by PhysWorld, so that a body is queued only once
+	bool isQueued() const { return isQueued_; }
+	void setQueued(const bool queued) { isQueued_ = queued; }
+
 	// Called on hits
 	virtual void onHit(const PhysContact& contact);
 	// Called on overlaps
@@ -79,6 +117,8 @@ private:
 	// Used to inform world when this body has changed (and thus should be evaluated for contacts)
 	// Only set directly from PhysWorld upon adding new PhysBody
 	PhysWorld* world_ = nullptr;
+	// Id of the body in the world, given in order of adding bodies
+	unsigned int id_ = 0;
 
 	// All colliders of this body
 	std::vector<std::unique_ptr<PhysCollider>> colliders_;
@@ -102,6 +142,15 @@ private:
 	// If true, body acts normally
 	// If false, it doesn't act at all
 	bool isActive_ = true;
+
+	// Time of world steps since the last step of the body
+	float pendingTime_ = 0;
+
+	// Partitions of the world the body can be in
+	PartitionRange partitionRange_;
+
+	// Body is queued for contact evaluation
+	bool isQueued_ = false;
 };
 
 #endif // __PHYS_BODY_H__
@@ -2,10 +2,13 @@
 #define __PHYS_BOX_COLLIDER_H__
 
 #include "PhysCollider.h"
+#include "PhysPool.h"
 
 // Box collider
 class PhysBoxCollider : public PhysCollider
 {
+	PHYS_POOLED(PhysBoxCollider)
+
 public:
 	// Return size
 	const cocos2d::Size& getSize() const { return size_; }
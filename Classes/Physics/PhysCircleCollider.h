@@ -2,10 +2,13 @@
 #define __PHYS_CIRCLE_COLLIDER_H__
 
 #include "PhysCollider.h"
+#include "PhysPool.h"
 
 // Circle collider
 class PhysCircleCollider : public PhysCollider
 {
+	PHYS_POOLED(PhysCircleCollider)
+
 public:
 	// Returns radius
 	const float& getRadius() const { return radius_; }
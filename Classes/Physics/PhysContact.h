@@ -1,11 +1,9 @@
 #ifndef __PHYS_CONTACT_H__
 #define __PHYS_CONTACT_H__
 
+#include "PhysBody.h"
 #include "cocos2d.h" // Just for basic things like Vec2
 
-// Forward declarations
-class PhysBody;
-
 // Represents special object that holds information about collision
 class PhysContact
 {
@@ -15,11 +13,14 @@ class PhysContact
 public:
 	// For hashing
 	// We consider contacts equal if bodies are equal even if directions and isHit_ are not
+	// Ids of bodies are used instead of pointers (see PhysBody::PhysBodyHasher)
 	struct PhysContactHasher
 	{
 		std::size_t operator()(const PhysContact& contact) const
 		{
-			return std::hash<PhysBody*>()(contact.a_) ^ std::hash<PhysBody*>()(contact.b_);
+			const uint64_t idA = contact.a_->getId();
+			const uint64_t idB = contact.b_->getId();
+			return std::hash<uint64_t>()(idA < idB ? (idA << 32) | idB : (idB << 32) | idA);
 		}
 	};
 	bool operator== (const PhysContact& other) const
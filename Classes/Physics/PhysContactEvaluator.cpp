@@ -8,6 +8,7 @@
 #include "Definitions.h"
 
 #include "cocos2d.h" // We use Vec2 for physics
+#include <algorithm>
 #include <array>
 
 USING_NS_CC;
@@ -26,6 +27,35 @@ bool PhysContactEvaluator::inRect(PhysBody* body, const Vec2& origin, const Size
 	// No collider is in rect
 	return false;
 }
+// Return rectangle around all colliders of body, just its position if it has none
+Rect PhysContactEvaluator::getBounds(PhysBody* body)
+{
+	if (!body)
+		throw std::invalid_argument("body can't be a null pointers");
+
+	auto min = body->getPosition();
+	auto max = body->getPosition();
+	auto isFirst = true;
+	for (auto& collider : body->getColliders()) {
+		Vec2 halfSize;
+		if (const auto circle = dynamic_cast<PhysCircleCollider*>(collider.get()))
+			halfSize = Vec2(circle->getRadius(), circle->getRadius());
+		else if (const auto box = dynamic_cast<PhysBoxCollider*>(collider.get()))
+			halfSize = Vec2(box->getSize() / 2);
+		else
+			continue; // unknown colliders aren't in any rect either
+		const auto center = body->getPosition() + collider->getPosition();
+		if (isFirst) {
+			min = center - halfSize;
+			max = center + halfSize;
+			isFirst = false;
+			continue;
+		}
+		min = Vec2(std::min(min.x, center.x - halfSize.x), std::min(min.y, center.y - halfSize.y));
+		max = Vec2(std::max(max.x, center.x + halfSize.x), std::max(max.y, center.y + halfSize.y));
+	}
+	return Rect(min, Size(max.x - min.x, max.y - min.y));
+}
 // Same for colliders
 bool PhysContactEvaluator::inRect(const Vec2& posBody, PhysCollider* collider, const Vec2& origin, const Size& size)
 {
@@ -18,6 +18,8 @@ public:
 	// Returns true if body's rectangle intersects specified rectangle
 	// Useful for partitions and other calculations
 	static bool inRect(PhysBody* body, const cocos2d::Vec2& origin, const cocos2d::Size& size);
+	// Return rectangle around all colliders of body, just its position if it has none
+	static cocos2d::Rect getBounds(PhysBody* body);
 private:
 	// Same for colliders
 	static bool inRect(const cocos2d::Vec2& posBody, PhysCollider* collider, const cocos2d::Vec2& origin, const cocos2d::Size& size);
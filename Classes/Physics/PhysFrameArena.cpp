@@ -0,0 +1,51 @@
+#include "PhysFrameArena.h"
+
+#include <algorithm>
+
+// Return aligned memory that is valid until reset
+void* PhysFrameArena::allocate(const std::size_t bytes, const std::size_t alignment)
+{
+	void* pointer = top_;
+	auto space = static_cast<std::size_t>(end_ - top_);
+	if (!std::align(alignment, bytes, pointer, space)) {
+		// Current block is full, continue in a new one
+		const auto size = std::max(bytes + alignment, capacity_);
+		overflowBlocks_.push_back(std::unique_ptr<char[]>(new char[size]));
+		overflowBytes_ += size;
+		top_ = overflowBlocks_.back().get();
+		end_ = top_ + size;
+
+		pointer = top_;
+		space = size;
+		std::align(alignment, bytes, pointer, space);
+	}
+	top_ = static_cast<char*>(pointer) + bytes;
+	return pointer;
+}
+// Memory is freed only on reset, but the last allocation can be given back (e.g. when vector grows)
+void PhysFrameArena::deallocate(void* pointer, const std::size_t bytes)
+{
+	if (static_cast<char*>(pointer) + bytes == top_)
+		top_ = static_cast<char*>(pointer);
+}
+
+// Free everything allocated since last reset
+void PhysFrameArena::reset()
+{
+	// Grow so that the whole last step fits into main block
+	if (!overflowBlocks_.empty()) {
+		capacity_ += overflowBytes_;
+		overflowBlocks_.clear();
+		overflowBytes_ = 0;
+		block_.reset(new char[capacity_]);
+	}
+	top_ = block_.get();
+	end_ = top_ + capacity_;
+}
+
+// Constructor
+PhysFrameArena::PhysFrameArena(const std::size_t capacity) : block_(new char[capacity]), capacity_(capacity)
+{
+	top_ = block_.get();
+	end_ = top_ + capacity_;
+}
@@ -0,0 +1,77 @@
+#ifndef __PHYS_FRAME_ARENA_H__
+#define __PHYS_FRAME_ARENA_H__
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+// Linear allocator for temporaries of one physics step
+// Allocation just moves a pointer, nothing is freed until reset at the start of the next step
+// If a step needs more memory than the arena has, extra blocks are taken from heap
+// and the arena grows to fit all of them on reset, so steady state doesn't touch heap at all
+class PhysFrameArena
+{
+public:
+	// Return aligned memory that is valid until reset
+	void* allocate(std::size_t bytes, std::size_t alignment);
+	// Memory is freed only on reset, but the last allocation can be given back (e.g. when vector grows)
+	void deallocate(void* pointer, std::size_t bytes);
+
+	// Free everything allocated since last reset
+	void reset();
+
+	// Return size of main block in bytes
+	std::size_t getCapacity() const { return capacity_; }
+
+	// Constructor
+	explicit PhysFrameArena(std::size_t capacity);
+
+	PhysFrameArena(const PhysFrameArena&) = delete;
+	PhysFrameArena& operator=(const PhysFrameArena&) = delete;
+
+private:
+	// Main block
+	std::unique_ptr<char[]> block_;
+	std::size_t capacity_;
+	// Start of free memory in the current block
+	char* top_;
+	char* end_;
+
+	// Blocks taken from heap when main block was full and their total size
+	std::vector<std::unique_ptr<char[]>> overflowBlocks_;
+	std::size_t overflowBytes_ = 0;
+};
+
+// Standard allocator that takes memory from a frame arena, for containers of one step
+// Containers using it must not outlive the step
+template<typename T>
+class PhysFrameAllocator
+{
+public:
+	using value_type = T;
+
+	explicit PhysFrameAllocator(PhysFrameArena& arena) : arena_(&arena) {}
+	template<typename U>
+	PhysFrameAllocator(const PhysFrameAllocator<U>& other) : arena_(other.getArena()) {}
+
+	T* allocate(const std::size_t n) { return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T))); }
+	void deallocate(T* pointer, const std::size_t n) { arena_->deallocate(pointer, n * sizeof(T)); }
+
+	PhysFrameArena* getArena() const { return arena_; }
+
+private:
+	PhysFrameArena* arena_;
+};
+template<typename T, typename U>
+bool operator==(const PhysFrameAllocator<T>& a, const PhysFrameAllocator<U>& b) { return a.getArena() == b.getArena(); }
+template<typename T, typename U>
+bool operator!=(const PhysFrameAllocator<T>& a, const PhysFrameAllocator<U>& b) { return a.getArena() != b.getArena(); }
+
+// Containers for temporaries of one step
+#define FRAME_VECTOR(T) std::vector<T, PhysFrameAllocator<T>>
+#define FRAME_CONTACTS_SET std::unordered_set<PhysContact, PhysContact::PhysContactHasher, std::equal_to<PhysContact>, PhysFrameAllocator<PhysContact>>
+#define FRAME_BODIES_SET std::unordered_set<PhysBody*, PhysBody::PhysBodyHasher, std::equal_to<PhysBody*>, PhysFrameAllocator<PhysBody*>>
+
+#endif // __PHYS_FRAME_ARENA_H__
@@ -32,6 +32,28 @@ void PhysLeftRightMovement::move(const float dT)
 	}
 }
 
+// Reset to the state of a new movement with the same curve, which starts over
+void PhysLeftRightMovement::reset(const Vec2& speed, const Vec2& acceleration)
+{
+	PhysMovement::reset(speed, acceleration);
+	curveK_ = startCurveK_;
+	goingDown_ = startGoingDown_;
+}
+// Reset to the state of a new movement with these parameters, angle function is kept
+void PhysLeftRightMovement::reset(const Vec2& speed, const float& angularSpeed, const float& curveTime, const float& curveK, const bool& goingDown)
+{
+	if (curveTime <= 0)
+		throw std::invalid_argument("curveTime should be > 0");
+	if (curveK < -1 || curveK > 1)
+		throw std::invalid_argument("curveK should be in [-1, 1]");
+
+	PhysMovement::reset(speed);
+	angularSpeed_ = angularSpeed;
+	curveTime_ = curveTime;
+	curveK_ = startCurveK_ = curveK;
+	goingDown_ = startGoingDown_ = goingDown;
+}
+
 // Constructors
 PhysLeftRightMovement::PhysLeftRightMovement(const cocos2d::Vec2& speed, const float& angularSpeed, const float& curveTime, const float& curveK, const bool& goingDown) : PhysLeftRightMovement(speed, angularSpeed, curveTime,
 // Default angle changing function
@@ -41,19 +63,12 @@ PhysLeftRightMovement::PhysLeftRightMovement(const cocos2d::Vec2& speed, const f
 		return angularSpeed * dT;
 	if (curveK < 0)
 		return -angularSpeed * dT;
+	return 0.0f;
 }, 
 curveK, goingDown) { }
 
 PhysLeftRightMovement::PhysLeftRightMovement(const cocos2d::Vec2& speed, const float& angularSpeed, const float& curveTime, const std::function<float(float, float, float)>& nextAngleFunction, const float& curveK, const bool& goingDown) : PhysMovement(speed)
 {
-	if (curveTime <= 0)
-		throw std::invalid_argument("curveTime should be > 0");
-	if (curveK < -1 || curveK > 1)
-		throw std::invalid_argument("curveK should be in [-1, 1]");
-
-	angularSpeed_ = angularSpeed;
-	curveTime_ = curveTime;
-	curveK_ = curveK;
+	reset(speed, angularSpeed, curveTime, curveK, goingDown);
 	nextAngleFunction_ = nextAngleFunction;
-	goingDown_ = goingDown;
 }
@@ -2,6 +2,7 @@
 #define __PHYS_LEFT_RIGHT_MOVEMENT_H__
 
 #include "PhysMovement.h"
+#include "PhysPool.h"
 #include <functional>
 
 // Forward declarations
@@ -10,10 +11,17 @@ class PhysBody;
 // Represents movement with constant speed magnitude but changing direction
 class PhysLeftRightMovement : public PhysMovement
 {
+	PHYS_POOLED(PhysLeftRightMovement)
+
 public:
 	// Evaluates body movement over a period of time
 	virtual void move(float dT) override;
 
+	// Reset to the state of a new movement with the same curve, which starts over
+	virtual void reset(const cocos2d::Vec2& speed, const cocos2d::Vec2& acceleration = cocos2d::Vec2::ZERO) override;
+	// Reset to the state of a new movement with these parameters, angle function is kept
+	void reset(const cocos2d::Vec2& speed, const float& angularSpeed, const float& curveTime, const float& curveK = 1, const bool& goingDown = true);
+
 	// Constructors
 	PhysLeftRightMovement(const cocos2d::Vec2& speed, const float& angularSpeed, const float& curveTime, const float& curveK = 1, const bool& goingDown = true);
 	PhysLeftRightMovement(const cocos2d::Vec2& speed, const float& angularSpeed, const float& curveTime, const std::function<float(float, float, float)>& nextAngleFunction, const float& curveK = 1, const bool& goingDown = true);
@@ -37,6 +45,10 @@ protected:
 
 	// True if curveK_ is going down
 	bool goingDown_ = true;
+
+	// Where the curve starts, reset brings it back there
+	float startCurveK_ = 1;
+	bool startGoingDown_ = true;
 };
 
 #endif // __PHYS_LEFT_RIGHT_MOVEMENT_H__
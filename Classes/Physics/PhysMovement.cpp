@@ -64,6 +64,14 @@ void PhysMovement::onHit(const PhysContact& contact)
 	}
 }
 
+// Reset to the state of a new movement, so that pooled bodies can reuse it
+void PhysMovement::reset(const Vec2& speed, const Vec2& acceleration)
+{
+	newSpeed_ = speed;
+	speed_ = Vec2::ZERO;
+	acceleration_ = acceleration;
+}
+
 // Evaluates body movement over a period of time
 void PhysMovement::move(const float dT)
 {
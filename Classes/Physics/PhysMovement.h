@@ -2,6 +2,7 @@
 #define __PHYS_MOVEMENT_H__
 
 #include "cocos2d.h" // Just for basic things like Vec2
+#include "PhysPool.h"
 
 // Forward declarations
 class PhysBody;
@@ -11,6 +12,8 @@ class PhysContact;
 // Every movement has speed. Children specify how it changes
 class PhysMovement
 {
+	PHYS_POOLED(PhysMovement)
+
 public:
 	// Set the body that will be changed by this movement_
 	// Should only be called from PhysBody directly when adding movement_
@@ -35,6 +38,10 @@ public:
 	// Stops the body. It may still move later
 	virtual void stop() { newSpeed_ = cocos2d::Vec2::ZERO; }
 
+	// Reset to the state of a new movement, so that pooled bodies can reuse it
+	// Children also reset their own state
+	virtual void reset(const cocos2d::Vec2& speed, const cocos2d::Vec2& acceleration = cocos2d::Vec2::ZERO);
+
 	// Constructor
 	explicit PhysMovement(const cocos2d::Vec2& speed = cocos2d::Vec2::ZERO, const cocos2d::Vec2& acceleration = cocos2d::Vec2::ZERO) : newSpeed_(speed), acceleration_(acceleration) {}
 
@@ -0,0 +1,165 @@
+#ifndef __PHYS_POOL_H__
+#define __PHYS_POOL_H__
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Objects in one block of a pool
+#ifndef PHYS_POOL_BLOCK_SIZE
+#define PHYS_POOL_BLOCK_SIZE 64
+#endif
+
+// Pool of fixed-size slots for objects of one type
+// Slots are taken from blocks of PHYS_POOL_BLOCK_SIZE objects, so objects of the same type are close in memory
+// Freed slots are reused, blocks are never given back to heap
+// Every thread has its own list of free slots, so parallel headless games don't wait for each other
+// Only new blocks and free slots of finished threads are shared, guarded by a mutex
+template<typename T>
+class PhysPool
+{
+public:
+	// Return memory for one object
+	static void* allocate()
+	{
+		auto local = getLocalPool();
+		if (!local)
+			return takeSharedSlots(false); // thread is finishing
+		if (!local->free)
+			local->free = takeSharedSlots(true);
+		auto slot = local->free;
+		local->free = slot->next;
+		return slot;
+	}
+	// Give memory of one object back to the pool
+	// It goes to the free slots of the current thread, even if it was allocated by another one
+	static void deallocate(void* pointer)
+	{
+		if (!pointer)
+			return;
+		auto slot = static_cast<Slot*>(pointer);
+		auto local = getLocalPool();
+		if (!local) {
+			slot->next = nullptr;
+			giveSharedSlots(slot); // thread is finishing
+			return;
+		}
+		slot->next = local->free;
+		local->free = slot;
+	}
+
+	PhysPool() = delete; // We don't want instances of this class
+
+private:
+	// Free slot points to the next free one, used slot holds an object
+	union Slot
+	{
+		Slot* next;
+		alignas(T) char storage[sizeof(T)];
+	};
+	struct Pool
+	{
+		std::mutex mutex;
+		Slot* free = nullptr;
+		std::vector<std::unique_ptr<Slot[]>> blocks;
+	};
+	// Free slots of one thread, given to the shared pool when the thread finishes
+	struct LocalPool
+	{
+		Slot* free = nullptr;
+		~LocalPool()
+		{
+			giveSharedSlots(free);
+			isLocalPoolDestroyed() = true;
+		}
+	};
+
+	// Take all shared free slots (or only one) as a list, creates a block if there are none
+	static Slot* takeSharedSlots(const bool all)
+	{
+		auto& pool = getPool();
+		std::lock_guard<std::mutex> lock(pool.mutex);
+		if (!pool.free) {
+			pool.blocks.push_back(std::unique_ptr<Slot[]>(new Slot[PHYS_POOL_BLOCK_SIZE]));
+			auto block = pool.blocks.back().get();
+			for (unsigned int i = 0; i < PHYS_POOL_BLOCK_SIZE; ++i)
+				block[i].next = i + 1 < PHYS_POOL_BLOCK_SIZE ? &block[i + 1] : nullptr;
+			pool.free = block;
+		}
+		auto slots = pool.free;
+		pool.free = all ? nullptr : slots->next;
+		return slots;
+	}
+	// Add a list of free slots to the shared ones
+	static void giveSharedSlots(Slot* slots)
+	{
+		if (!slots)
+			return;
+		auto last = slots;
+		while (last->next)
+			last = last->next;
+		auto& pool = getPool();
+		std::lock_guard<std::mutex> lock(pool.mutex);
+		last->next = pool.free;
+		pool.free = slots;
+	}
+
+	// Never destroyed, so that objects can be deleted during static destruction
+	static Pool& getPool()
+	{
+		static auto pool = new Pool();
+		return *pool;
+	}
+	// Return free slots of the current thread, nullptr once they were given back while the thread finishes
+	static LocalPool* getLocalPool()
+	{
+		if (isLocalPoolDestroyed())
+			return nullptr;
+		thread_local LocalPool local;
+		return &local;
+	}
+	// Trivial, so it can still be read after thread local objects are destroyed
+	static bool& isLocalPoolDestroyed()
+	{
+		thread_local bool destroyed = false;
+		return destroyed;
+	}
+};
+
+// Standard allocator that takes single objects from their pool, for node-based containers that live long
+// Nodes of sets are reused after erase, so steady state doesn't touch heap
+// Arrays (e.g. buckets of sets) still come from heap, they only grow
+template<typename T>
+class PhysPoolAllocator
+{
+public:
+	using value_type = T;
+
+	PhysPoolAllocator() = default;
+	template<typename U>
+	PhysPoolAllocator(const PhysPoolAllocator<U>&) {}
+
+	T* allocate(const std::size_t n) { return static_cast<T*>(n == 1 ? PhysPool<T>::allocate() : ::operator new(n * sizeof(T))); }
+	void deallocate(T* pointer, const std::size_t n)
+	{
+		if (n == 1)
+			PhysPool<T>::deallocate(pointer);
+		else
+			::operator delete(pointer);
+	}
+};
+template<typename T, typename U>
+bool operator==(const PhysPoolAllocator<T>&, const PhysPoolAllocator<U>&) { return true; }
+template<typename T, typename U>
+bool operator!=(const PhysPoolAllocator<T>&, const PhysPoolAllocator<U>&) { return false; }
+
+// Makes new and delete of a class use its pool, put in the class declaration
+// Derived classes without their own pool have different size and use heap
+#define PHYS_POOLED(T) \
+public: \
+	static void* operator new(std::size_t size) { return size == sizeof(T) ? PhysPool<T>::allocate() : ::operator new(size); } \
+	static void operator delete(void* pointer, std::size_t size) { if (size == sizeof(T)) PhysPool<T>::deallocate(pointer); else ::operator delete(pointer); }
+
+#endif // __PHYS_POOL_H__
@@ -0,0 +1,72 @@
+#include "PhysProfiler.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// Add profile of the next step, the oldest one is forgotten when window is full
+void PhysProfiler::addStep(const PhysStepProfile& profile)
+{
+	if (profiles_.size() < windowSize_)
+		profiles_.push_back(profile);
+	else
+		profiles_[next_] = profile;
+	next_ = (next_ + 1) % windowSize_;
+}
+
+// Statistics of a phase, of the whole step and of counters over recent steps
+PhysProfileStats PhysProfiler::getPhaseStats(const PhysPhase phase) const
+{
+	return getStats([phase](const PhysStepProfile& profile) { return profile.getPhaseTime(phase); });
+}
+PhysProfileStats PhysProfiler::getTotalStats() const
+{
+	return getStats([](const PhysStepProfile& profile) { return profile.getTotalTime(); });
+}
+PhysProfileStats PhysProfiler::getBodiesStats() const
+{
+	return getStats([](const PhysStepProfile& profile) { return profile.bodies; });
+}
+PhysProfileStats PhysProfiler::getPairsTestedStats() const
+{
+	return getStats([](const PhysStepProfile& profile) { return profile.pairsTested; });
+}
+PhysProfileStats PhysProfiler::getContactsStats() const
+{
+	return getStats([](const PhysStepProfile& profile) { return profile.contacts; });
+}
+PhysProfileStats PhysProfiler::getEventsStats() const
+{
+	return getStats([](const PhysStepProfile& profile) { return profile.events; });
+}
+
+// Statistics of any value of profiles
+template<class Getter>
+PhysProfileStats PhysProfiler::getStats(Getter getter) const
+{
+	PhysProfileStats stats;
+	if (profiles_.empty())
+		return stats;
+
+	std::vector<double> values;
+	values.reserve(profiles_.size());
+	for (const auto& profile : profiles_)
+		values.push_back(getter(profile));
+
+	stats.min = *std::min_element(values.begin(), values.end());
+	for (auto value : values)
+		stats.average += value;
+	stats.average /= values.size();
+	const auto index = std::min(values.size() - 1, values.size() * 99 / 100);
+	std::nth_element(values.begin(), values.begin() + index, values.end());
+	stats.p99 = values[index];
+	return stats;
+}
+
+// Constructor
+PhysProfiler::PhysProfiler(const size_t windowSize) : windowSize_(windowSize)
+{
+	if (windowSize == 0)
+		throw std::invalid_argument("window size should be > 0");
+
+	profiles_.reserve(windowSize);
+}
@@ -0,0 +1,131 @@
+#ifndef __PHYS_PROFILER_H__
+#define __PHYS_PROFILER_H__
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+// Timers and counters of physics step phases
+// Enabled in debug builds, can be forced with PHYS_PROFILING=0 or 1 (tools enable it in CMakeLists.txt)
+// When disabled, they are compiled out and cost nothing
+#ifndef PHYS_PROFILING
+#if defined(COCOS2D_DEBUG) && COCOS2D_DEBUG > 0
+#define PHYS_PROFILING 1
+#else
+#define PHYS_PROFILING 0
+#endif
+#endif
+
+// Phases of PhysWorld::step in the order they happen
+enum class PhysPhase
+{
+	REMOVAL, // removing bodies marked for removal
+	INTEGRATION, // steps of bodies
+	BROADPHASE, // updating partitions
+	NARROWPHASE, // testing pairs of bodies for contacts
+	CONTACT_DIFF, // finding new and ended contacts
+	CALLBACKS, // onHit and onOverlap of bodies
+	COUNT
+};
+#define N_PHYS_PHASES static_cast<size_t>(PhysPhase::COUNT)
+
+// Durations of phases and amounts of work of one physics step
+struct PhysStepProfile
+{
+	// In microseconds, indexed by PhysPhase
+	double phaseTimes[N_PHYS_PHASES] = {};
+
+	// Bodies in the world
+	unsigned int bodies = 0;
+	// Pairs of bodies tested for contact
+	unsigned int pairsTested = 0;
+	// Bodies far from focus that didn't step
+	unsigned int stepsSkipped = 0;
+	// Contacts after the step
+	unsigned int contacts = 0;
+	// onHit and onOverlap calls
+	unsigned int events = 0;
+
+	double getPhaseTime(PhysPhase phase) const { return phaseTimes[static_cast<size_t>(phase)]; }
+	double getTotalTime() const
+	{
+		double total = 0;
+		for (auto time : phaseTimes)
+			total += time;
+		return total;
+	}
+
+	// Name of a phase for reports
+	static const char* getPhaseName(const PhysPhase phase)
+	{
+		static const char* names[N_PHYS_PHASES] = { "Removal", "Integration", "Broadphase", "Narrowphase", "ContactDiff", "Callbacks" };
+		return names[static_cast<size_t>(phase)];
+	}
+};
+
+// Adds time between its construction and destruction to a value (in microseconds)
+class PhysScopedTimer
+{
+public:
+	explicit PhysScopedTimer(double& target) : target_(target), start_(std::chrono::steady_clock::now()) {}
+	~PhysScopedTimer() { target_ += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_).count(); }
+
+	PhysScopedTimer(const PhysScopedTimer&) = delete;
+	PhysScopedTimer& operator=(const PhysScopedTimer&) = delete;
+
+private:
+	double& target_;
+	std::chrono::steady_clock::time_point start_;
+};
+
+// Times the rest of current scope as a phase of the profile
+// Adds to a counter of the profile
+#if PHYS_PROFILING
+#define PHYS_PROFILE_PHASE(profile, phase) PhysScopedTimer physPhaseTimer((profile).phaseTimes[static_cast<size_t>(phase)])
+#define PHYS_PROFILE_COUNT(counter, value) ((counter) += (value))
+#else
+#define PHYS_PROFILE_PHASE(profile, phase)
+#define PHYS_PROFILE_COUNT(counter, value)
+#endif
+
+// Statistics of one value over recent steps
+struct PhysProfileStats
+{
+	double min = 0;
+	double average = 0;
+	double p99 = 0; // 99th percentile
+};
+
+// Keeps profiles of recent steps and computes their statistics
+class PhysProfiler
+{
+public:
+	// Add profile of the next step, the oldest one is forgotten when window is full
+	void addStep(const PhysStepProfile& profile);
+
+	// Statistics of a phase, of the whole step and of counters over recent steps
+	PhysProfileStats getPhaseStats(PhysPhase phase) const;
+	PhysProfileStats getTotalStats() const;
+	PhysProfileStats getBodiesStats() const;
+	PhysProfileStats getPairsTestedStats() const;
+	PhysProfileStats getContactsStats() const;
+	PhysProfileStats getEventsStats() const;
+
+	// Return number of steps in the window
+	size_t getStepCount() const { return profiles_.size(); }
+
+	// Constructor
+	explicit PhysProfiler(size_t windowSize = 120);
+
+private:
+	// Statistics of any value of profiles
+	template<class Getter>
+	PhysProfileStats getStats(Getter getter) const;
+
+	// Recent profiles, used as a ring buffer
+	std::vector<PhysStepProfile> profiles_;
+	size_t windowSize_;
+	size_t next_ = 0;
+};
+
+#endif // __PHYS_PROFILER_H__
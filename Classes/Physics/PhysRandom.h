@@ -0,0 +1,74 @@
+#ifndef __PHYS_RANDOM_H__
+#define __PHYS_RANDOM_H__
+
+#include <cstdint>
+#include <utility>
+
+// Small and fast random number generator (PCG32) that belongs to a PhysWorld
+// Same seed always gives the same numbers on every platform
+// That is not guaranteed by std distributions and std::shuffle, so they shouldn't be used with it
+class PhysRandom
+{
+public:
+	// Restart the sequence from seed
+	void setSeed(const uint64_t seed)
+	{
+		seed_ = seed;
+		state_ = 0;
+		next();
+		state_ += seed;
+		next();
+	}
+	// Return seed
+	uint64_t getSeed() const { return seed_; }
+
+	// Next 32 random bits
+	uint32_t next()
+	{
+		const auto oldState = state_;
+		state_ = oldState * 6364136223846793005ULL + INCREMENT;
+		const auto xorShifted = static_cast<uint32_t>(((oldState >> 18u) ^ oldState) >> 27u);
+		const auto rotation = static_cast<uint32_t>(oldState >> 59u);
+		return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+	}
+
+	// Random float in [0, 1)
+	float next_0_1() { return (next() >> 8) * (1.0f / 16777216.0f); }
+	// Random float in [-1, 1)
+	float next_minus1_1() { return next_0_1() * 2 - 1; }
+	// Random float in [min, max)
+	float nextInRange(const float min, const float max) { return min + next_0_1() * (max - min); }
+	// Random integer in [0, bound), without modulo bias
+	uint32_t nextBelow(const uint32_t bound)
+	{
+		if (bound == 0)
+			return 0;
+		const auto threshold = (0u - bound) % bound;
+		while (true) {
+			const auto value = next();
+			if (value >= threshold)
+				return value % bound;
+		}
+	}
+
+	// Fisher-Yates shuffle of random access range
+	template <class Iterator>
+	void shuffle(Iterator begin, Iterator end)
+	{
+		const auto size = static_cast<uint32_t>(end - begin);
+		for (uint32_t i = size; i > 1; --i)
+			std::swap(begin[i - 1], begin[nextBelow(i)]);
+	}
+
+	// Constructor
+	explicit PhysRandom(const uint64_t seed = 0) { setSeed(seed); }
+
+private:
+	// Any odd number selects the stream
+	static const uint64_t INCREMENT = 1442695040888963407ULL;
+
+	uint64_t state_ = 0;
+	uint64_t seed_ = 0;
+};
+
+#endif // __PHYS_RANDOM_H__
@@ -2,6 +2,10 @@
 #include "PhysBody.h"
 #include "PhysContactEvaluator.h"
 #include "Definitions.h"
+#include "Trace.h"
+#include "AllocationTracker.h"
+#include <algorithm>
+#include <cmath>
 
 USING_NS_CC;
 
@@ -11,9 +15,9 @@ void PhysWorld::addBody(std::unique_ptr<PhysBody> body)
 	if (!body || !body.get())
 		throw std::invalid_argument("body can't be nullptr");
 
-	body->setWorld(this);
+	body->setWorld(this, nextBodyId_++);
 	if (body->isActive())
-		forEvaluation_.insert(body.get());
+		addForEvaluation(body.get());
 	bodies_.push_back(std::move(body));
 }
 void PhysWorld::removeBody(PhysBody* body)
@@ -40,106 +44,195 @@ void PhysWorld::removeFromContacts(PhysBody* body)
 // Removes body from all partitions
 void PhysWorld::removeFromPartitions(PhysBody* body)
 {
-	for (auto& partition : partitions_)
-		partition.erase(body);
+	const auto range = body->getPartitionRange();
+	if (range.isEmpty())
+		return;
+	for (auto row = range.minRow; row <= range.maxRow; ++row)
+		for (auto column = range.minColumn; column <= range.maxColumn; ++column)
+			partitions_[row * nPartitionsX_ + column].erase(body);
+	body->setPartitionRange(PhysBody::PartitionRange());
+}
+
+// Queues body for evaluation, once
+void PhysWorld::addForEvaluation(PhysBody* body)
+{
+	if (body->isQueued())
+		return;
+	body->setQueued(true);
+	forEvaluation_.push_back(body);
+}
+// Removes body from the evaluation queue
+void PhysWorld::removeFromEvaluation(PhysBody* body)
+{
+	if (!body->isQueued())
+		return;
+	body->setQueued(false);
+	forEvaluation_.erase(std::find(forEvaluation_.begin(), forEvaluation_.end(), body));
 }
 
 // Finds collisions, sends events (and can move physics simulation if we were actually simulating something)
 void PhysWorld::step(const float dT)
 {
+	ALLOCATION_SCOPE("Physics");
+	lastStepProfile_ = PhysStepProfile();
+	frameArena_.reset();
+	const PhysFrameAllocator<char> frameAllocator(frameArena_);
+
 	// First remove all for removal
-	for (auto body : forRemoval_) {
-		forEvaluation_.erase(body);
-		removeFromContacts(body);
-		removeFromPartitions(body);
-		//bodies_.erase(std::find_if(bodies_.begin(), bodies_.end(), [&body](auto b) { return body == b.get(); }));
-		for (auto it = bodies_.begin(); it != bodies_.end(); ++it)
-			if (it->get() == body) {
-				bodies_.erase(it);
-				break;
-			}
+	{
+		PHYS_PROFILE_PHASE(lastStepProfile_, PhysPhase::REMOVAL);
+		TRACE_SCOPE("PhysWorld::step Removal");
+		for (auto body : forRemoval_) {
+			removeFromEvaluation(body);
+			removeFromContacts(body);
+			removeFromPartitions(body);
+			//bodies_.erase(std::find_if(bodies_.begin(), bodies_.end(), [&body](auto b) { return body == b.get(); }));
+			for (auto it = bodies_.begin(); it != bodies_.end(); ++it)
+				if (it->get() == body) {
+					bodies_.erase(it);
+					break;
+				}
+		}
+		forRemoval_.clear();
 	}
-	forRemoval_.clear();
 
 	// Then call steps in all active bodies
-	const auto currentBodiesSize = bodies_.size();
-	// Can't do that since bodies can sometimes create new bodies in their step (but can't delete)
-	// for(auto body : bodies_)
-	for (unsigned int i = 0; i < currentBodiesSize; ++i) {
-		auto body = bodies_[i].get();
-		if (body->isActive())
-			body->step(dT);
+	// Bodies far from focus wait for their turn and then step with all the time they waited
+	{
+		PHYS_PROFILE_PHASE(lastStepProfile_, PhysPhase::INTEGRATION);
+		TRACE_SCOPE("PhysWorld::step Integration");
+		++stepCount_;
+		const auto currentBodiesSize = bodies_.size();
+		// Can't do that since bodies can sometimes create new bodies in their step (but can't delete)
+		// for(auto body : bodies_)
+		for (unsigned int i = 0; i < currentBodiesSize; ++i) {
+			auto body = bodies_[i].get();
+			if (!body->isActive())
+				continue;
+
+			const auto time = body->addPendingTime(dT);
+			const auto interval = getStepInterval(body);
+			if (interval > 1 && (stepCount_ + body->getId()) % interval != 0) {
+				PHYS_PROFILE_COUNT(lastStepProfile_.stepsSkipped, 1);
+				continue;
+			}
+			body->clearPendingTime();
+			body->step(time);
+		}
 	}
 
 	// We store forEvaluation for each partition now
-	std::vector<std::list<PhysBody*>> forEvaluationInPartitions(partitions_.size());
+	std::vector<FRAME_VECTOR(PhysBody*), PhysFrameAllocator<FRAME_VECTOR(PhysBody*)>> forEvaluationInPartitions(
+		partitions_.size(), FRAME_VECTOR(PhysBody*)(frameAllocator), frameAllocator);
 
 	// Update partitions
 	// Partitions are needed for faster computations
-	for (auto& body : forEvaluation_) {
-		for (unsigned int i = 0; i < partitions_.size(); ++i) {
-			if (PhysContactEvaluator::inRect(body, getPartitionsOrigin(i), partitionSize_)) {
-				partitions_[i].insert(body);
-				forEvaluationInPartitions[i].push_back(body);
+	// Only partitions the body was in and those its bounds overlap now are updated
+	{
+		PHYS_PROFILE_PHASE(lastStepProfile_, PhysPhase::BROADPHASE);
+		TRACE_SCOPE("PhysWorld::step Broadphase");
+		for (auto& body : forEvaluation_) {
+			const auto oldRange = body->getPartitionRange();
+			const auto newRange = getPartitionRange(body);
+			auto range = newRange;
+			if (!oldRange.isEmpty()) {
+				range.minColumn = std::min(range.minColumn, oldRange.minColumn);
+				range.minRow = std::min(range.minRow, oldRange.minRow);
+				range.maxColumn = std::max(range.maxColumn, oldRange.maxColumn);
+				range.maxRow = std::max(range.maxRow, oldRange.maxRow);
 			}
-			else
-				partitions_[i].erase(body);
+
+			for (auto row = range.minRow; row <= range.maxRow; ++row)
+				for (auto column = range.minColumn; column <= range.maxColumn; ++column) {
+					const auto i = row * nPartitionsX_ + column;
+					const auto isInNewRange = column >= newRange.minColumn && column <= newRange.maxColumn && row >= newRange.minRow && row <= newRange.maxRow;
+					if (isInNewRange && PhysContactEvaluator::inRect(body, getPartitionsOrigin(i), partitionSize_)) {
+						partitions_[i].insert(body);
+						forEvaluationInPartitions[i].push_back(body);
+					}
+					else
+						partitions_[i].erase(body);
+				}
+			body->setPartitionRange(newRange);
 		}
 	}
-	forEvaluation_.clear();
 
 	// Now start testing for collisions
-	CONTACTS_SET newContacts;
-	for (unsigned int i = 0; i < partitions_.size(); ++i)
+	FRAME_CONTACTS_SET newContacts(0, PhysContact::PhysContactHasher(), std::equal_to<PhysContact>(), frameAllocator);
 	{
-		std::unordered_set<PhysBody*> testedBodies;
-		for (auto& bodyA : forEvaluationInPartitions[i])
+		PHYS_PROFILE_PHASE(lastStepProfile_, PhysPhase::NARROWPHASE);
+		TRACE_SCOPE("PhysWorld::step Narrowphase");
+		for (unsigned int i = 0; i < partitions_.size(); ++i)
 		{
-			testedBodies.insert(bodyA);
-			for (auto& bodyB : partitions_[i]) {
-				if (testedBodies.find(bodyB) != testedBodies.end()) // if testedBodies.contains(bodyB)
-					continue;
+			if (forEvaluationInPartitions[i].empty())
+				continue;
+			FRAME_BODIES_SET testedBodies(forEvaluationInPartitions[i].size(), PhysBody::PhysBodyHasher(), std::equal_to<PhysBody*>(), frameAllocator);
+			for (auto& bodyA : forEvaluationInPartitions[i])
+			{
+				testedBodies.insert(bodyA);
+				for (auto& bodyB : partitions_[i]) {
+					if (testedBodies.find(bodyB) != testedBodies.end()) // if testedBodies.contains(bodyB)
+						continue;
 
-				PhysContact contact;
-				if (!PhysContactEvaluator::intersects(bodyA, bodyB, contact))
-					continue;
+					PhysContact contact;
+					PHYS_PROFILE_COUNT(lastStepProfile_.pairsTested, 1);
+					if (!PhysContactEvaluator::intersects(bodyA, bodyB, contact))
+						continue;
 
-				// Contact occured, but it may be old. For now, just save it
-				newContacts.insert(contact);
+					// Contact occured, but it may be old. For now, just save it
+					newContacts.insert(contact);
+				}
 			}
 		}
 	}
 
 	// We now have all the contacts and need to find, which ones are new
-	// First we remove old contacts
-	std::vector<PhysContact> forRemovalFromCurrent;
-	for (const auto& contact : currentContacts_)
 	{
-		if (newContacts.find(contact) != newContacts.end()) // if newContacts.contains(contact)
-			newContacts.erase(contact); // it's an old contact, remove from new
-		else
-			forRemovalFromCurrent.push_back(contact); // it's not a contact anymore, mark from removal from current
-	}
+		PHYS_PROFILE_PHASE(lastStepProfile_, PhysPhase::CONTACT_DIFF);
+		TRACE_SCOPE("PhysWorld::step ContactDiff");
+		// First we remove old contacts
+		// Only contacts of evaluated bodies were tested, others (e.g. of two far bodies that skipped this step) are kept
+		FRAME_VECTOR(PhysContact) forRemovalFromCurrent(frameAllocator);
+		forRemovalFromCurrent.reserve(currentContacts_.size());
+		for (const auto& contact : currentContacts_)
+		{
+			if (newContacts.find(contact) != newContacts.end()) // if newContacts.contains(contact)
+				newContacts.erase(contact); // it's an old contact, remove from new
+			else if (contact.getBodyA()->isQueued() || contact.getBodyB()->isQueued())
+				forRemovalFromCurrent.push_back(contact); // it's not a contact anymore, mark from removal from current
+		}
 
-	// Remove old contacts that are no longer contacts
-	for (const auto& contact : forRemovalFromCurrent)
-		currentContacts_.erase(contact);
+		// Remove old contacts that are no longer contacts
+		for (const auto& contact : forRemovalFromCurrent)
+			currentContacts_.erase(contact);
+		for (auto body : forEvaluation_)
+			body->setQueued(false);
+		forEvaluation_.clear();
+	}
 
 	// Add new contacts to current and notify bodies
-	for (const auto& contact : newContacts)
 	{
-		currentContacts_.insert(contact);
+		PHYS_PROFILE_PHASE(lastStepProfile_, PhysPhase::CALLBACKS);
+		TRACE_SCOPE("PhysWorld::step Callbacks");
+		for (const auto& contact : newContacts)
+		{
+			currentContacts_.insert(contact);
+			PHYS_PROFILE_COUNT(lastStepProfile_.events, 2);
 
-		// Decide if it's hit or overlap
-		if (contact.isHit()) {
-			contact.getBodyA()->onHit(contact);
-			contact.getBodyB()->onHit(contact);
-		}
-		else {
-			contact.getBodyA()->onOverlap(contact);
-			contact.getBodyB()->onOverlap(contact);
+			// Decide if it's hit or overlap
+			if (contact.isHit()) {
+				contact.getBodyA()->onHit(contact);
+				contact.getBodyB()->onHit(contact);
+			}
+			else {
+				contact.getBodyA()->onOverlap(contact);
+				contact.getBodyB()->onOverlap(contact);
+			}
 		}
 	}
+
+	PHYS_PROFILE_COUNT(lastStepProfile_.bodies, bodies_.size());
+	PHYS_PROFILE_COUNT(lastStepProfile_.contacts, currentContacts_.size());
 }
 
 // Called from bodies when they are moved or changed in other ways
@@ -150,31 +243,86 @@ void PhysWorld::onManipulatedBody(PhysBody* body)
 		throw std::invalid_argument("body can't be nullptr");
 
 	if (body->isActive())
-		forEvaluation_.insert(body);
+		addForEvaluation(body);
 	else
 	{
-		forEvaluation_.erase(body);
+		removeFromEvaluation(body);
 		removeFromContacts(body);
 		removeFromPartitions(body);
 	}
 }
 
+// Set area around the camera and the player where bodies are fully simulated
+void PhysWorld::setFocus(const Rect& focus)
+{
+	if (focus.size.width <= 0 || focus.size.height <= 0)
+		throw std::invalid_argument("focus can't be empty");
+
+	focus_ = focus;
+	hasFocus_ = true;
+	lodTierDistance_ = PHYS_LOD_TIER_DISTANCE * focus.size.width;
+}
+
+// Return number of world steps between steps of body, 1 in focus
+unsigned int PhysWorld::getStepInterval(const PhysBody* body) const
+{
+	if (!hasFocus_)
+		return 1;
+
+	// Distance outside of focus along the farther axis
+	const auto& pos = body->getPosition();
+	const auto distance = std::max(std::max(focus_.getMinX() - pos.x, pos.x - focus_.getMaxX()), std::max(focus_.getMinY() - pos.y, pos.y - focus_.getMaxY()));
+	if (distance <= 0)
+		return 1;
+
+	const auto tier = std::min(static_cast<unsigned int>(distance / lodTierDistance_) + 1, static_cast<unsigned int>(PHYS_LOD_MAX_TIER));
+	return 1u << tier;
+}
+
 // Return partition's origin
 Vec2 PhysWorld::getPartitionsOrigin(const unsigned int index) const
 {
 	if (index > partitions_.size())
 		throw std::out_of_range("index of partitions out of range");
 
-	const auto column = index % N_PARTITIONS_X;
-	const auto row = index / N_PARTITIONS_X;
+	const auto column = index % nPartitionsX_;
+	const auto row = index / nPartitionsX_;
 	return origin_ + Vec2(column * partitionSize_.width, row * partitionSize_.height);
 }
 
+// Returns partitions that body's bounds overlap
+// Bodies that touch each other share at least the partition of a common point, so contacts are found in one of them
+PhysBody::PartitionRange PhysWorld::getPartitionRange(PhysBody* body) const
+{
+	const auto bounds = PhysContactEvaluator::getBounds(body);
+	const auto toColumn = [this](const float x) {
+		return static_cast<unsigned int>(clampf(std::floor((x - origin_.x) / partitionSize_.width), 0, static_cast<float>(nPartitionsX_ - 1)));
+	};
+	const auto toRow = [this](const float y) {
+		return static_cast<unsigned int>(clampf(std::floor((y - origin_.y) / partitionSize_.height), 0, static_cast<float>(nPartitionsY_ - 1)));
+	};
+
+	PhysBody::PartitionRange range;
+	range.minColumn = toColumn(bounds.getMinX());
+	range.maxColumn = toColumn(bounds.getMaxX());
+	range.minRow = toRow(bounds.getMinY());
+	range.maxRow = toRow(bounds.getMaxY());
+	return range;
+}
+
 // Constructor
-PhysWorld::PhysWorld(const Vec2& origin, const Size& size) : size_(size), origin_(origin)
+PhysWorld::PhysWorld(const Vec2& origin, const Size& size, const uint64_t seed) : size_(size), origin_(origin), random_(seed), frameArena_(PHYS_FRAME_ARENA_SIZE)
 {
-	partitions_ = std::vector<std::unordered_set<PhysBody*>>(N_PARTITIONS_X * N_PARTITIONS_Y);
-	partitionSize_ = Size(size_.width / N_PARTITIONS_X, size.height / N_PARTITIONS_Y);
+	nPartitionsX_ = std::max(static_cast<unsigned int>(N_PARTITIONS_X), static_cast<unsigned int>(std::ceil(size.width / PARTITION_MAX_SIZE.width)));
+	nPartitionsY_ = std::max(static_cast<unsigned int>(N_PARTITIONS_Y), static_cast<unsigned int>(std::ceil(size.height / PARTITION_MAX_SIZE.height)));
+	partitions_ = std::vector<BODIES_SET>(nPartitionsX_ * nPartitionsY_);
+	partitionSize_ = Size(size_.width / nPartitionsX_, size.height / nPartitionsY_);
+
+	// Containers that live between steps grow only when a step needs more
+	forEvaluation_.reserve(PHYS_EVALUATION_CAPACITY);
+	currentContacts_.reserve(PHYS_CONTACTS_CAPACITY);
+	for (auto& partition : partitions_)
+		partition.reserve(PHYS_PARTITION_CAPACITY);
 }
 // Needed to avoid problems with smart pointers
 PhysWorld::~PhysWorld() = default;
@@ -2,13 +2,17 @@
 #define __PHYS_WORLD_H__
 
 #include "cocos2d.h"
+#include "PhysBody.h"
 #include "PhysContact.h"
+#include "PhysRandom.h"
+#include "PhysProfiler.h"
+#include "PhysFrameArena.h"
+#include "PhysPool.h"
 #include <unordered_set>
 
-#define CONTACTS_SET std::unordered_set<PhysContact, PhysContact::PhysContactHasher>
-
-// Forward declarations
-class PhysBody;
+// Sets that live between steps take their nodes from pools, so steady-state step doesn't touch heap
+#define CONTACTS_SET std::unordered_set<PhysContact, PhysContact::PhysContactHasher, std::equal_to<PhysContact>, PhysPoolAllocator<PhysContact>>
+#define BODIES_SET std::unordered_set<PhysBody*, PhysBody::PhysBodyHasher, std::equal_to<PhysBody*>, PhysPoolAllocator<PhysBody*>>
 
 // Physics world that stores all the bodies and evaluates their contacts in step function
 // When world is destroyed, all memory for all of its bodies is cleared
@@ -26,6 +30,10 @@ private:
 	void removeFromContacts(PhysBody* body);
 	// Removes body from all partitions
 	void removeFromPartitions(PhysBody* body);
+	// Queues body for evaluation, once
+	void addForEvaluation(PhysBody* body);
+	// Removes body from the evaluation queue
+	void removeFromEvaluation(PhysBody* body);
 
 public:
 	// Return all current contacts
@@ -34,17 +42,35 @@ public:
 	// Finds collisions, sends events (and can move physics simulation if we were actually simulating something)
 	void step(float dT);
 
+	// Set area around the camera and the player where bodies are fully simulated
+	// Bodies outside it step once in 2, 4 ... 2^PHYS_LOD_MAX_TIER steps (with all the time since their last step), the further the less often
+	// So they are also evaluated for contacts only at these steps, until they come closer
+	// Without a focus all bodies step every step
+	void setFocus(const cocos2d::Rect& focus);
+
 	// Called from bodies when they are moved or changed in other ways
 	// Sets these bodies for evaluation, or removes them from evaluation if they are not active anymore
 	void onManipulatedBody(PhysBody* body);
 
+	// Return durations of phases and amounts of work of the last step
+	// All zeros unless PHYS_PROFILING is enabled
+	const PhysStepProfile& getLastStepProfile() const { return lastStepProfile_; }
+
+	// Return random number generator of this world
+	// All randomness of the world should come from it, so that same seed gives the same simulation
+	PhysRandom& getRandom() { return random_; }
+
 private:
 	// Returns partition's origin
 	cocos2d::Vec2 getPartitionsOrigin(unsigned int index) const;
+	// Returns partitions that body's bounds overlap
+	PhysBody::PartitionRange getPartitionRange(PhysBody* body) const;
+	// Returns number of world steps between steps of body, 1 in focus
+	unsigned int getStepInterval(const PhysBody* body) const;
 
 public:
 	// Constructor
-	PhysWorld(const cocos2d::Vec2& origin, const cocos2d::Size& size);
+	PhysWorld(const cocos2d::Vec2& origin, const cocos2d::Size& size, uint64_t seed = 0);
 	// Needed to avoid problems with smart pointers
 	~PhysWorld();
 
@@ -58,21 +84,43 @@ private:
 
 	// All bodies handled by this world
 	std::vector<std::unique_ptr<PhysBody>> bodies_;
+	// Id for the next added body
+	unsigned int nextBodyId_ = 1;
+
+	// Random number generator of this world
+	PhysRandom random_;
+
+	// Bodies outside of focus step less often
+	cocos2d::Rect focus_;
+	bool hasFocus_ = false;
+	float lodTierDistance_ = 0;
+	// Number of steps, staggers steps of far bodies by their ids
+	unsigned int stepCount_ = 0;
+
+	// Durations of phases and amounts of work of the last step
+	PhysStepProfile lastStepProfile_;
+
+	// Memory for temporary containers of step, reset at the start of each step
+	PhysFrameArena frameArena_;
 
 	// All contacts detected in this world
 	CONTACTS_SET currentContacts_;
 
 	// All bodies that should be checked for collisions next
-	// We need set so that one body isn't added for evaluation several times
-	std::unordered_set<PhysBody*> forEvaluation_; 
+	// Bodies are flagged as queued, so that one body isn't added for evaluation several times
+	// Reserved once, clearing keeps the memory for the next step
+	std::vector<PhysBody*> forEvaluation_;
 
 	// Bodies are removed only at the start of new step to avoid problems
-	std::unordered_set<PhysBody*> forRemoval_;
+	BODIES_SET forRemoval_;
 
 	// Bodies in partitions of the world
 	// Needed to make computations faster
-	std::vector<std::unordered_set<PhysBody*>> partitions_;
+	// Larger worlds have more partitions, so that each holds about as many bodies as in a one screen world
+	std::vector<BODIES_SET> partitions_;
 	cocos2d::Size partitionSize_;
+	unsigned int nPartitionsX_;
+	unsigned int nPartitionsY_;
 };
 
 #endif // __PHYS_WORLD_H__
@@ -12,5 +12,9 @@
 #include "PhysContactEvaluator.h"
 #include "PhysMovement.h"
 #include "PhysLeftRightMovement.h"
+#include "PhysProfiler.h"
+#include "PhysFrameArena.h"
+#include "PhysPool.h"
+#include "PhysRandom.h"
 
 #endif // __PHYSICS_H__
@@ -2,6 +2,10 @@
 
 #include "MenuScene.h"
 #include "Definitions.h"
+#include "AudioManager.h"
+#include "AssetPreloader.h"
+#include "Trace.h"
+#include "AllocationTracker.h"
 
 #include "audio/include/SimpleAudioEngine.h"
 using namespace CocosDenshion;
@@ -20,36 +24,84 @@ bool SplashScene::init()
 	if (!Scene::init())
 		return false;
 
-	// Preload sounds
-	SimpleAudioEngine::getInstance()->preloadBackgroundMusic(GAME_BACKGROUND_MUSIC);
-	SimpleAudioEngine::getInstance()->preloadBackgroundMusic(MENU_BACKGROUND_MUSIC);
-	SimpleAudioEngine::getInstance()->preloadEffect(CLICK_SOUND_EFFECT);
-	SimpleAudioEngine::getInstance()->preloadEffect(LASER_BOUNCE_SOUND_EFFECT);
-	SimpleAudioEngine::getInstance()->preloadEffect(LASER_HIT_SOUND_EFFECT);
-	SimpleAudioEngine::getInstance()->preloadEffect(SCORE_TICK_SOUND_EFFECT);
-	SimpleAudioEngine::getInstance()->preloadEffect(SHOOT_NORMAL_SOUND_EFFECT);
-	SimpleAudioEngine::getInstance()->preloadEffect(SHOOT_POWERFUL_SOUND_EFFECT);
-	SimpleAudioEngine::getInstance()->preloadEffect(TIME_OUT_SOUND_EFFECT);
-	SimpleAudioEngine::getInstance()->preloadEffect(TIME_TICK_SOUND_EFFECT);
-	SimpleAudioEngine::getInstance()->preloadEffect(WIN_SOUND_EFFECT);
-
 	// Background music
+	SimpleAudioEngine::getInstance()->preloadBackgroundMusic(MENU_BACKGROUND_MUSIC);
 	SimpleAudioEngine::getInstance()->playBackgroundMusic(MENU_BACKGROUND_MUSIC, true);
 
 	// Background image
 	auto splashSprite = Sprite::create(SPLASH_SCREEN_SPRITE);
 	splashSprite->setPosition(CENTER);
 	this->addChild(splashSprite);
-		
-	// Go to main menu in a bit
-	this->scheduleOnce(schedule_selector(SplashScene::continueToMenu), SPLASH_SCREEN_DURATION);
+
+	// Loading progress
+	progressBar_ = DrawNode::create();
+	this->addChild(progressBar_);
+
+	// Images and particles are decoded on worker threads
+	preloader_ = std::make_unique<AssetPreloader>();
+	for (const auto file : { BACKGROUND_SPRITE, TITLE_SPRITE, EXIT_BUTTON_NORMAL_SPRITE, EXIT_BUTTON_PRESSED_SPRITE, PLAY_BUTTON_NORMAL_SPRITE, PLAY_BUTTON_PRESSED_SPRITE,
+		MENU_BUTTON_NORMAL_SPRITE, MENU_BUTTON_PRESSED_SPRITE, RETRY_BUTTON_NORMAL_SPRITE, RETRY_BUTTON_PRESSED_SPRITE, GAMEPLAY_ATLAS, WIN_SPRITE, LOSS_SPRITE })
+		preloader_->addImage(file);
+	for (const auto file : { STARS_PARTICLES, SPARKS_PARTICLES, LASER_BALL_TRAIL_PARTICLES, GUNSHIP_BOOSTERS_PARTICLES, ASTEROID_BREAK_PARTICLES,
+		ASTEROID_BOUNCED_PARTICLES, CURSOR_PARTICLES })
+		preloader_->addParticles(file);
+
+	// Sounds and fonts can only be loaded on the main thread
+	preloader_->addMainThreadTask([]() {
+		SimpleAudioEngine::getInstance()->preloadBackgroundMusic(GAME_BACKGROUND_MUSIC);
+	});
+	preloader_->addMainThreadTask([]() {
+		auto audio = AudioManager::getInstance();
+		audio->preloadEffect(CLICK_SOUND_EFFECT, CLICK_SOUND_SETTINGS);
+		audio->preloadEffect(LASER_BOUNCE_SOUND_EFFECT, LASER_BOUNCE_SOUND_SETTINGS);
+		audio->preloadEffect(LASER_HIT_SOUND_EFFECT, LASER_HIT_SOUND_SETTINGS);
+		audio->preloadEffect(SCORE_TICK_SOUND_EFFECT, SCORE_TICK_SOUND_SETTINGS);
+		audio->preloadEffect(SHOOT_NORMAL_SOUND_EFFECT, SHOOT_NORMAL_SOUND_SETTINGS);
+		audio->preloadEffect(SHOOT_POWERFUL_SOUND_EFFECT, SHOOT_POWERFUL_SOUND_SETTINGS);
+		audio->preloadEffect(TIME_OUT_SOUND_EFFECT, TIME_OUT_SOUND_SETTINGS);
+		audio->preloadEffect(TIME_TICK_SOUND_EFFECT, TIME_TICK_SOUND_SETTINGS);
+		audio->preloadEffect(WIN_SOUND_EFFECT, WIN_SOUND_SETTINGS);
+	});
+	for (const float fontSize : { GAME_UI_FONT_SIZE, GAME_OVER_NUMBER_TEXT_FONT_SIZE, GAME_OVER_NUMBER_FONT_SIZE })
+		preloader_->addMainThreadTask([fontSize]() {
+			// Same atlas as Label::createWithTTF uses
+			TTFConfig config(MAIN_FONT, fontSize);
+			auto atlas = FontAtlasCache::getFontAtlasTTF(&config);
+			if (atlas)
+				atlas->prepareLetterDefinitions(FONT_PRELOAD_GLYPHS);
+		});
+	preloader_->start();
+
+	this->scheduleUpdate();
 
 	return true;
 }
 
+// Show loading progress, go to main menu when assets are ready
+void SplashScene::update(const float dT)
+{
+	time_ += dT;
+	preloader_->update();
+
+	const auto left = Vec2(CENTER_X - SPLASH_PROGRESS_BAR_WIDTH / 2, SPLASH_PROGRESS_BAR_Y);
+	progressBar_->clear();
+	progressBar_->drawSolidRect(left, left + Vec2(SPLASH_PROGRESS_BAR_WIDTH * preloader_->getProgress(), SPLASH_PROGRESS_BAR_HEIGHT), SPLASH_PROGRESS_BAR_COLOR);
+
+	if (!leaving_ && preloader_->isDone() && time_ >= SPLASH_SCREEN_DURATION) {
+		leaving_ = true;
+		continueToMenu(dT);
+	}
+}
+
+// Needed to avoid problems with smart pointers
+SplashScene::SplashScene() = default;
+SplashScene::~SplashScene() = default;
+
 // Go to main menu
 void SplashScene::continueToMenu(float dT)
 {
+	TRACE_SCOPE("Transition to MenuScene");
+	ALLOCATION_SCOPE("Scenes");
 	const auto scene = MenuScene::createScene();
 	Director::getInstance()->replaceScene(SCENE_TRANSITION(scene));
 }
@@ -2,6 +2,7 @@
 #define __SPLASH_SCENE_H__
 
 #include "cocos2d.h"
+#include <memory>
 
 // Screen at the start of the game
 class SplashScene : public cocos2d::Scene
@@ -11,12 +12,26 @@ public:
 
 	virtual bool init() override;
 
+	// Show loading progress, go to main menu when assets are ready
+	virtual void update(float dT) override;
+
 	// static create()
 	CREATE_FUNC(SplashScene);
 
+	// Needed to avoid problems with smart pointers
+	SplashScene();
+	~SplashScene();
+
 private:
 	// Go to main menu
 	void continueToMenu(float dT);
+
+	// Loads assets of other scenes
+	std::unique_ptr<class AssetPreloader> preloader_;
+	cocos2d::DrawNode* progressBar_ = nullptr;
+	// Time on the splash screen
+	float time_ = 0;
+	bool leaving_ = false;
 };
 
 #endif // __SPLASH_SCENE_H__
@@ -0,0 +1,37 @@
+#include "SpriteManifest.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+USING_NS_CC;
+
+// Sorted by file
+// CMake builds include the table they generated in the build directory, other builds the committed copy
+static const SpriteInfo sprites[] = {
+#if GENERATED_SPRITE_MANIFEST
+#include "Generated/SpriteManifestData.h"
+#else
+#include "SpriteManifestData.h"
+#endif
+};
+
+// Return info of sprite file (e.g. GUNSHIP_SPRITE), throws invalid_argument if it isn't in the manifest
+const SpriteInfo& SpriteManifest::get(const std::string& file)
+{
+	const auto foundIt = std::lower_bound(std::begin(sprites), std::end(sprites), file, [](const SpriteInfo& sprite, const std::string& file) {
+		return std::strcmp(sprite.file, file.c_str()) < 0;
+	});
+	if (foundIt == std::end(sprites) || file != foundIt->file)
+		throw std::invalid_argument(file + " is not in the sprite manifest");
+	return *foundIt;
+}
+
+// Create sprite of file from its texture rect, throws invalid_argument if the texture can't be loaded
+Sprite* SpriteManifest::createSprite(const std::string& file)
+{
+	const auto& sprite = get(file);
+	const auto texture = Director::getInstance()->getTextureCache()->addImage(sprite.texture);
+	if (!texture)
+		throw std::invalid_argument(std::string("can't load texture ") + sprite.texture);
+	return Sprite::createWithTexture(texture, sprite.getRect());
+}
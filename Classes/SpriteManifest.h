@@ -0,0 +1,33 @@
+#ifndef __SPRITE_MANIFEST_H__
+#define __SPRITE_MANIFEST_H__
+
+#include "cocos2d.h"
+#include <string>
+
+// What the game needs to know about a sprite before (or without) loading its texture
+struct SpriteInfo
+{
+	const char* file;
+	float width, height; // of the image
+	float radius; // of its circle collider
+	const char* texture; // file of the texture that has the image
+	float x, y; // of the image in the texture
+
+	cocos2d::Size getSize() const { return cocos2d::Size(width, height); }
+	cocos2d::Rect getRect() const { return cocos2d::Rect(x, y, width, height); }
+};
+
+// Sizes, collider radii and texture rects of all sprites, generated at build time by manifest_generator
+// Level layout and colliders use it, so headless simulations never read images
+// Gameplay sprites share one atlas texture, so consecutive entities of all types are drawn in one batch
+// Can be used from any thread, the table is constant
+class SpriteManifest
+{
+public:
+	// Return info of sprite file (e.g. GUNSHIP_SPRITE), throws invalid_argument if it isn't in the manifest
+	static const SpriteInfo& get(const std::string& file);
+	// Create sprite of file from its texture rect, throws invalid_argument if the texture can't be loaded
+	static cocos2d::Sprite* createSprite(const std::string& file);
+};
+
+#endif // __SPRITE_MANIFEST_H__
@@ -0,0 +1,20 @@
+// Generated by manifest_generator from Resources/sprites, don't edit
+// { file, width, height, collider radius, texture, x and y in texture }
+
+{ "sprites/Asteroid.png", 160, 160, 80.0f, "atlases/Gameplay.png", 2, 2 },
+{ "sprites/Background.png", 1920, 1080, 960.0f, "sprites/Background.png", 0, 0 },
+{ "sprites/ExitButtonNormal.png", 183, 54, 91.5f, "sprites/ExitButtonNormal.png", 0, 0 },
+{ "sprites/ExitButtonPressed.png", 183, 54, 91.5f, "sprites/ExitButtonPressed.png", 0, 0 },
+{ "sprites/Gun.png", 72, 33, 36.0f, "atlases/Gameplay.png", 260, 2 },
+{ "sprites/Gunship.png", 90, 90, 45.0f, "atlases/Gameplay.png", 166, 2 },
+{ "sprites/LaserBall.png", 27, 27, 13.5f, "atlases/Gameplay.png", 336, 2 },
+{ "sprites/LossLabel.png", 704, 104, 352.0f, "sprites/LossLabel.png", 0, 0 },
+{ "sprites/MenuButtonNormal.png", 182, 54, 91.0f, "sprites/MenuButtonNormal.png", 0, 0 },
+{ "sprites/MenuButtonPressed.png", 182, 54, 91.0f, "sprites/MenuButtonPressed.png", 0, 0 },
+{ "sprites/PlayButtonNormal.png", 177, 54, 88.5f, "sprites/PlayButtonNormal.png", 0, 0 },
+{ "sprites/PlayButtonPressed.png", 177, 54, 88.5f, "sprites/PlayButtonPressed.png", 0, 0 },
+{ "sprites/RetryButtonNormal.png", 228, 54, 114.0f, "sprites/RetryButtonNormal.png", 0, 0 },
+{ "sprites/RetryButtonPressed.png", 228, 54, 114.0f, "sprites/RetryButtonPressed.png", 0, 0 },
+{ "sprites/SplashScreen.png", 1920, 1080, 960.0f, "sprites/SplashScreen.png", 0, 0 },
+{ "sprites/Title.png", 595, 95, 297.5f, "sprites/Title.png", 0, 0 },
+{ "sprites/WinLabel.png", 607, 104, 303.5f, "sprites/WinLabel.png", 0, 0 },
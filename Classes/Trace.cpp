@@ -0,0 +1,113 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+// Start/end of an event that can't be scoped, must be nested properly on each thread
+void Trace::begin(const char* name)
+{
+	record(name, 'B', now());
+}
+void Trace::end(const char* name)
+{
+	record(name, 'E', now());
+}
+// Event with known start and duration (in microseconds since start of trace)
+void Trace::complete(const char* name, const uint64_t start, const uint64_t duration)
+{
+	record(name, 'X', start, duration);
+}
+// Event without duration
+void Trace::instant(const char* name)
+{
+	record(name, 'i', now());
+}
+
+// Microseconds since start of trace
+uint64_t Trace::now()
+{
+	static const auto start = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Add event to buffer of current thread
+void Trace::record(const char* name, const char phase, const uint64_t timestamp, const uint64_t duration)
+{
+	auto& buffer = getBuffer();
+	const auto index = buffer.written.load(std::memory_order_relaxed);
+	buffer.events[index % TRACE_BUFFER_SIZE] = { name, phase, timestamp, duration };
+	buffer.written.store(index + 1, std::memory_order_release);
+}
+
+// Return buffer of current thread, creates it on first use
+Trace::Buffer& Trace::getBuffer()
+{
+	thread_local Buffer* buffer = nullptr;
+	if (!buffer) {
+		std::lock_guard<std::mutex> lock(getBuffersMutex());
+		auto& buffers = getBuffers();
+		buffers.push_back(std::make_unique<Buffer>());
+		buffer = buffers.back().get();
+		buffer->threadIndex = static_cast<unsigned int>(buffers.size() - 1);
+	}
+	return *buffer;
+}
+
+// All buffers ever created and mutex for adding and reading them
+// Buffers are never destroyed, so events of finished threads can still be written
+std::vector<std::unique_ptr<Trace::Buffer>>& Trace::getBuffers()
+{
+	static std::vector<std::unique_ptr<Buffer>> buffers;
+	return buffers;
+}
+std::mutex& Trace::getBuffersMutex()
+{
+	static std::mutex mutex;
+	return mutex;
+}
+
+// Write all recorded events of all threads to a JSON file
+// Returns false if file can't be written
+bool Trace::writeJson(const std::string& path)
+{
+	std::ofstream stream(path);
+	if (!stream)
+		return false;
+
+	stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	auto first = true;
+	std::lock_guard<std::mutex> lock(getBuffersMutex());
+	for (auto& pointer : getBuffers()) {
+		const auto& buffer = *pointer;
+
+		// Copy events that are still in the buffer
+		const auto written = buffer.written.load(std::memory_order_acquire);
+		const auto oldest = written > TRACE_BUFFER_SIZE ? written - TRACE_BUFFER_SIZE : 0;
+		std::vector<Event> events;
+		events.reserve(written - oldest);
+		for (auto i = oldest; i < written; ++i)
+			events.push_back(buffer.events[i % TRACE_BUFFER_SIZE]);
+		// Thread could overwrite some of them while copying
+		// It may also be writing the next event into the slot of the oldest remaining one
+		const auto writtenAfter = buffer.written.load(std::memory_order_acquire);
+		const auto overwritten = writtenAfter >= TRACE_BUFFER_SIZE ? writtenAfter - TRACE_BUFFER_SIZE + 1 : 0;
+		const auto skipped = overwritten > oldest ? std::min<uint64_t>(overwritten - oldest, events.size()) : 0;
+
+		// Name of the thread
+		stream << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.threadIndex
+			<< ",\"args\":{\"name\":\"" << (buffer.threadIndex == 0 ? "Main" : "Thread ") << (buffer.threadIndex == 0 ? "" : std::to_string(buffer.threadIndex)) << "\"}}";
+		first = false;
+
+		for (auto it = events.begin() + skipped; it != events.end(); ++it) {
+			stream << ",\n{\"name\":\"" << it->name << "\",\"ph\":\"" << it->phase << "\",\"ts\":" << it->timestamp;
+			if (it->phase == 'X')
+				stream << ",\"dur\":" << it->duration;
+			if (it->phase == 'i')
+				stream << ",\"s\":\"t\"";
+			stream << ",\"pid\":1,\"tid\":" << buffer.threadIndex << "}";
+		}
+	}
+	stream << "\n]}\n";
+	return static_cast<bool>(stream);
+}
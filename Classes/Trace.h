@@ -0,0 +1,107 @@
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Timeline of what the game does, saved as Chrome trace event JSON (open in Perfetto or chrome://tracing)
+// Enabled in debug builds, can be forced with TRACING=0 or 1
+// When disabled, all TRACE_ macros are compiled out and cost nothing
+#ifndef TRACING
+#if defined(COCOS2D_DEBUG) && COCOS2D_DEBUG > 0
+#define TRACING 1
+#else
+#define TRACING 0
+#endif
+#endif
+
+// Events kept for every thread, older ones are overwritten
+#define TRACE_BUFFER_SIZE 65536
+
+// Records events into per-thread ring buffers
+// Writing is lock-free, every thread only writes to its own buffer
+// Names should be string literals, they are stored as pointers
+// The first thread that records an event is shown as main thread
+class Trace
+{
+public:
+	// Start/end of an event that can't be scoped, must be nested properly on each thread
+	static void begin(const char* name);
+	static void end(const char* name);
+	// Event with known start and duration (in microseconds since start of trace)
+	static void complete(const char* name, uint64_t start, uint64_t duration);
+	// Event without duration
+	static void instant(const char* name);
+
+	// Microseconds since start of trace
+	static uint64_t now();
+
+	// Write all recorded events of all threads to a JSON file
+	// Returns false if file can't be written
+	static bool writeJson(const std::string& path);
+
+	Trace() = delete; // We don't want instances of this class
+
+private:
+	// One recorded event
+	struct Event
+	{
+		const char* name;
+		char phase; // 'B', 'E', 'X' or 'i' as in trace event format
+		uint64_t timestamp;
+		uint64_t duration;
+	};
+
+	// Ring buffer of one thread
+	// Only its thread writes, writeJson reads and skips events that were overwritten while reading
+	struct Buffer
+	{
+		unsigned int threadIndex = 0;
+		std::vector<Event> events = std::vector<Event>(TRACE_BUFFER_SIZE);
+		std::atomic<uint64_t> written{ 0 };
+	};
+
+	// Add event to buffer of current thread
+	static void record(const char* name, char phase, uint64_t timestamp, uint64_t duration = 0);
+	// Return buffer of current thread, creates it on first use
+	static Buffer& getBuffer();
+
+	// All buffers ever created and mutex for adding and reading them
+	// Buffers are never destroyed, so events of finished threads can still be written
+	static std::vector<std::unique_ptr<Buffer>>& getBuffers();
+	static std::mutex& getBuffersMutex();
+};
+
+// Records time between its construction and destruction as one event
+class TraceScope
+{
+public:
+	explicit TraceScope(const char* name) : name_(name), start_(Trace::now()) {}
+	~TraceScope() { Trace::complete(name_, start_, Trace::now() - start_); }
+
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+	const char* name_;
+	uint64_t start_;
+};
+
+// Trace the rest of current scope / mark a moment / start and end an event
+#if TRACING
+#define TRACE_SCOPE(name) TraceScope traceScope(name)
+#define TRACE_INSTANT(name) Trace::instant(name)
+#define TRACE_BEGIN(name) Trace::begin(name)
+#define TRACE_END(name) Trace::end(name)
+#else
+#define TRACE_SCOPE(name)
+#define TRACE_INSTANT(name)
+#define TRACE_BEGIN(name)
+#define TRACE_END(name)
+#endif
+
+#endif // __TRACE_H__
@@ -0,0 +1,90 @@
+#include "TrailBatch.h"
+#include "ParticleCache.h"
+#include <algorithm>
+
+USING_NS_CC;
+
+// Return batch of the scene for particle file, creates it on first use
+// Batch can hold particles of maxEmitters emitters emitting at once
+TrailBatch* TrailBatch::getFor(Scene* scene, const std::string& file, const int zOrder, const unsigned int maxEmitters)
+{
+	if (!scene)
+		throw std::invalid_argument("scene can't be nullptr");
+
+	auto batch = dynamic_cast<TrailBatch*>(scene->getChildByName(file));
+	if (!batch) {
+		batch = TrailBatch::create(file, maxEmitters);
+		batch->setName(file);
+		scene->addChild(batch, zOrder);
+	}
+	return batch;
+}
+
+// Add/remove an emitter, returns its index
+unsigned int TrailBatch::addEmitter(const Vec2& pos, const Color4F& color)
+{
+	unsigned int emitter;
+	if (!freeEmitters_.empty()) {
+		emitter = freeEmitters_.back();
+		freeEmitters_.pop_back();
+	}
+	else {
+		emitter = static_cast<unsigned int>(emitterPositions_.size());
+		emitterPositions_.emplace_back();
+		emitterColors_.emplace_back();
+		emitterCounters_.emplace_back();
+		emittersActive_.emplace_back();
+	}
+
+	emitterPositions_[emitter] = pos;
+	emitterColors_[emitter] = color;
+	emitterCounters_[emitter] = 0;
+	emittersActive_[emitter] = true;
+	return emitter;
+}
+void TrailBatch::removeEmitter(const unsigned int emitter)
+{
+	emittersActive_[emitter] = false;
+	freeEmitters_.push_back(emitter);
+}
+
+// Emit particles of all emitters, then update all particles
+void TrailBatch::update(const float dT)
+{
+	for (unsigned int i = 0; i < emitterPositions_.size(); ++i) {
+		if (!emittersActive_[i])
+			continue;
+
+		emitterCounters_[i] += emitterRate_ * dT;
+		const auto count = std::max(std::min(static_cast<int>(emitterCounters_[i]), getTotalParticles() - getParticleCount()), 0);
+		// Particles that don't fit into a full batch are dropped, instead of coming all at once later
+		emitterCounters_[i] = std::min(emitterCounters_[i] - count, 1.0f);
+		if (count == 0)
+			continue;
+
+		// New particles take source position and start color of the system
+		setSourcePosition(emitterPositions_[i]);
+		setStartColor(emitterColors_[i]);
+		addParticles(count);
+	}
+
+	// Emission rate is 0, so it only moves and ages particles
+	ParticleSystemQuad::update(dT);
+}
+
+// Create from particle file
+TrailBatch* TrailBatch::create(const std::string& file, const unsigned int maxEmitters)
+{
+	auto batch = new TrailBatch();
+	if (!ParticleCache::getInstance()->init(batch, file)) {
+		delete batch;
+		throw std::invalid_argument("can't create particles from " + file);
+	}
+	batch->autorelease();
+
+	// Particles are only emitted by emitters
+	batch->emitterRate_ = batch->getEmissionRate();
+	batch->setEmissionRate(0);
+	batch->setTotalParticles(batch->getTotalParticles() * maxEmitters);
+	return batch;
+}
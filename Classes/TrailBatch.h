@@ -0,0 +1,49 @@
+#ifndef __TRAIL_BATCH_H__
+#define __TRAIL_BATCH_H__
+
+#include "cocos2d.h"
+#include <string>
+#include <vector>
+
+// One particle system shared by trails of many objects (e.g. all laser balls)
+// Every object has an emitter with its own source position and color, all particles are updated together and drawn in one batch
+// Particle settings come from a plist, its emission rate is the rate of each emitter
+// Lives in the scene, one batch per particle file
+class TrailBatch : public cocos2d::ParticleSystemQuad
+{
+public:
+	// Return batch of the scene for particle file, creates it on first use
+	// Batch can hold particles of maxEmitters emitters emitting at once
+	static TrailBatch* getFor(cocos2d::Scene* scene, const std::string& file, int zOrder, unsigned int maxEmitters);
+
+	// Add/remove an emitter, returns its index
+	unsigned int addEmitter(const cocos2d::Vec2& pos, const cocos2d::Color4F& color);
+	void removeEmitter(unsigned int emitter);
+
+	// Change an emitter
+	void setEmitterPosition(unsigned int emitter, const cocos2d::Vec2& pos) { emitterPositions_[emitter] = pos; }
+	void setEmitterColor(unsigned int emitter, const cocos2d::Color4F& color) { emitterColors_[emitter] = color; }
+	// Inactive emitters don't emit, their particles still fade out
+	void setEmitterActive(unsigned int emitter, const bool active) { emittersActive_[emitter] = active; }
+
+	// Emit particles of all emitters, then update all particles
+	virtual void update(float dT) override;
+
+private:
+	// Create from particle file
+	static TrailBatch* create(const std::string& file, unsigned int maxEmitters);
+
+private:
+	// Particles per second of each emitter
+	float emitterRate_ = 0;
+
+	// Emitters, indexed by emitter
+	std::vector<cocos2d::Vec2> emitterPositions_;
+	std::vector<cocos2d::Color4F> emitterColors_;
+	std::vector<float> emitterCounters_; // particles to emit, fractions are carried to the next update
+	std::vector<bool> emittersActive_;
+	// Removed emitters, reused by addEmitter
+	std::vector<unsigned int> freeEmitters_;
+};
+
+#endif // __TRAIL_BATCH_H__
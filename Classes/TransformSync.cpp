@@ -0,0 +1,66 @@
+#include "TransformSync.h"
+#include "GameObject.h"
+#include "Definitions.h"
+#include "Trace.h"
+
+USING_NS_CC;
+
+// Return sync of the scene, creates it on first use
+TransformSync* TransformSync::getFor(Scene* scene)
+{
+	if (!scene)
+		throw std::invalid_argument("scene can't be nullptr");
+
+	auto sync = dynamic_cast<TransformSync*>(scene->getChildByName(TRANSFORM_SYNC_NAME));
+	if (!sync) {
+		sync = TransformSync::create();
+		sync->setName(TRANSFORM_SYNC_NAME);
+		sync->view_ = Rect(Director::getInstance()->getVisibleOrigin(), Director::getInstance()->getVisibleSize());
+		scene->addChild(sync);
+	}
+	return sync;
+}
+
+// Add/remove a dirty game object
+void TransformSync::add(GameObject* object)
+{
+	if (object->dirtyIndex_ != GameObject::NOT_DIRTY)
+		return;
+	object->dirtyIndex_ = static_cast<unsigned int>(dirty_.size());
+	dirty_.push_back(object);
+}
+void TransformSync::remove(GameObject* object)
+{
+	const auto index = object->dirtyIndex_;
+	if (index == GameObject::NOT_DIRTY)
+		return;
+	dirty_[index] = dirty_.back();
+	dirty_[index]->dirtyIndex_ = index;
+	dirty_.pop_back();
+	object->dirtyIndex_ = GameObject::NOT_DIRTY;
+}
+
+// True if a node at position can be seen
+bool TransformSync::isInView(const Vec2& pos) const
+{
+	return pos.x >= view_.getMinX() - CULLING_MARGIN && pos.x <= view_.getMaxX() + CULLING_MARGIN
+		&& pos.y >= view_.getMinY() - CULLING_MARGIN && pos.y <= view_.getMaxY() + CULLING_MARGIN;
+}
+
+// Move nodes of all dirty game objects
+void TransformSync::flush(const float alpha)
+{
+	TRACE_SCOPE("TransformSync::flush");
+
+	// Objects that reached their last position are dropped, the rest are compacted in place
+	unsigned int kept = 0;
+	for (auto object : dirty_) {
+		if (object->syncToScene(alpha)) {
+			object->dirtyIndex_ = kept;
+			dirty_[kept++] = object;
+		}
+		else
+			object->dirtyIndex_ = GameObject::NOT_DIRTY;
+	}
+	dirty_.resize(kept);
+}
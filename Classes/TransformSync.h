@@ -0,0 +1,48 @@
+#ifndef __TRANSFORM_SYNC_H__
+#define __TRANSFORM_SYNC_H__
+
+#include "cocos2d.h"
+#include <vector>
+
+// Forward declarations
+class GameObject;
+
+// Moves scene nodes of game objects to their physics positions once per rendered frame
+// Physics positions stay authoritative, game objects only mark themselves dirty when they move during steps
+// Nodes are placed between positions of the last two steps, so motion is smooth when frames and steps don't line up
+// Nodes that move out of the view are hidden, so that they aren't visited
+// Lives in the scene, one per scene
+class TransformSync : public cocos2d::Node
+{
+public:
+	// Return sync of the scene, creates it on first use
+	static TransformSync* getFor(cocos2d::Scene* scene);
+
+	// Add/remove a dirty game object
+	void add(GameObject* object);
+	void remove(GameObject* object);
+
+	// Move nodes of all dirty game objects, alpha is how far the frame is from the previous step to the last one (0 to 1)
+	// Objects that are still between two positions stay dirty
+	void flush(float alpha);
+
+	// Set/get area of the scene that is drawn, starts as the visible area of the screen
+	// Objects are culled when they move, so a moving camera should set it before flush
+	void setViewRect(const cocos2d::Rect& view) { view_ = view; }
+	const cocos2d::Rect& getViewRect() const { return view_; }
+	// True if a node at position can be seen, nodes reach up to CULLING_MARGIN from their position
+	bool isInView(const cocos2d::Vec2& pos) const;
+
+	// Return number of dirty game objects
+	unsigned int getDirtyCount() const { return static_cast<unsigned int>(dirty_.size()); }
+
+	CREATE_FUNC(TransformSync);
+
+private:
+	// Dirty game objects, each one knows its index
+	std::vector<GameObject*> dirty_;
+	// Area of the scene that is drawn
+	cocos2d::Rect view_;
+};
+
+#endif // __TRANSFORM_SYNC_H__
@@ -0,0 +1,36 @@
+// Packs resources into one archive that the game maps instead of opening every file
+// Usage: asset_packer <archive file> <resources directories...>
+//
+// The build runs it when resources change and copies the archive next to the copied resources as ASSET_ARCHIVE_FILE
+// Files of later directories replace those of earlier ones, so generated resources (e.g. the atlas) replace committed copies
+// Sounds are left out, audio engines open them by path, so they stay loose files
+// Files are sorted by path and aligned, compressed only if that saves at least 10%
+
+#include "AssetArchive.h"
+#include "Definitions.h"
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+	if (argc < 3) {
+		std::cerr << "Usage: asset_packer <archive file> <resources directories...>" << std::endl;
+		return 1;
+	}
+
+	try {
+		AssetArchive::pack(std::vector<std::string>(argv + 2, argv + argc), argv[1], ASSET_ARCHIVE_SKIPPED_EXTENSIONS);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	// Check that the game can read it
+	AssetArchive archive;
+	if (!archive.open(argv[1])) {
+		std::cerr << "Packed archive " << argv[1] << " is not valid" << std::endl;
+		return 1;
+	}
+	std::cout << "Packed " << archive.getFileCount() << " files into " << argv[1] << std::endl;
+	return 0;
+}
@@ -0,0 +1,210 @@
+// Runs many headless games in parallel for balancing
+// Usage: batch_runner <grid file> <results file> [threads] [resources directory]
+//
+// Grid file has the same format as input.txt, but every tag can have several comma separated values:
+//   CountTarget=10,20,40
+//   Speed=300,500
+//   Time=20
+//   AsteroidMaxSpeed=0.04,0.08
+//   Runs=100 (games per configuration, each with its own seed)
+//   Seed=1 (seed of the first game, next games use next seeds)
+// Every combination of values is played Runs times and aggregated into one line of the CSV results file
+
+#include "GameSimulation.h"
+#include "Definitions.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+USING_NS_CC;
+
+// Tag that is only used in grid file
+#define GRID_RUNS_TAG "Runs"
+
+// Result of one game
+struct RunResult
+{
+	bool isWin = false;
+	unsigned int score = 0;
+	float elapsedTime = 0;
+	unsigned int steps = 0;
+	double seconds = 0; // real time spent in steps
+	double maxStepSeconds = 0; // slowest step
+};
+
+// Values of one tag
+typedef std::vector<std::string> GridValues;
+
+// Read grid file: tag -> all values, keeps the order of tags
+static std::vector<std::pair<std::string, GridValues>> readGrid(const std::string& input)
+{
+	std::vector<std::pair<std::string, GridValues>> grid;
+	std::stringstream inputStream(input);
+	while (!inputStream.eof()) {
+		std::string line;
+		std::getline(inputStream, line);
+		std::stringstream lineStream(line);
+		std::string tag;
+		if (!std::getline(lineStream, tag, '=') || lineStream.eof())
+			continue; // not a tag line
+		GridValues values;
+		std::string value;
+		while (std::getline(lineStream, value, ','))
+			values.push_back(value);
+		if (!values.empty())
+			grid.emplace_back(tag, values);
+	}
+	return grid;
+}
+
+// Make contents of input file for one combination of values
+static std::string makeInput(const std::vector<std::pair<std::string, GridValues>>& grid, const std::vector<size_t>& indices)
+{
+	std::string input;
+	for (size_t i = 0; i < grid.size(); ++i)
+		input += grid[i].first + "=" + grid[i].second[indices[i]] + "\n";
+	return input;
+}
+
+// Return single value of a tag or default value
+static unsigned int getGridValue(const std::vector<std::pair<std::string, GridValues>>& grid, const std::string& tag, const unsigned int defaultValue)
+{
+	for (auto& pair : grid)
+		if (pair.first == tag)
+			return std::stoul(pair.second.front());
+	return defaultValue;
+}
+
+// Play one game as fast as possible
+// Only steps are timed, level generation and autopilot aren't
+static RunResult runGame(const GameSimulationConfig& config)
+{
+	RunResult result;
+
+	// Each game has its own world, so games don't share anything
+	GameSimulation simulation(config);
+	while (simulation.isPlaying()) {
+		simulation.setInput(simulation.getAutopilotInput());
+		const auto start = std::chrono::steady_clock::now();
+		simulation.step(PHYSICS_UPDATE_INTERVAL);
+		const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		result.seconds += seconds;
+		result.maxStepSeconds = std::max(result.maxStepSeconds, seconds);
+		++result.steps;
+	}
+
+	result.isWin = simulation.isWin();
+	result.score = simulation.getScore();
+	result.elapsedTime = simulation.getElapsedTime();
+	return result;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3) {
+		std::cerr << "Usage: " << argv[0] << " <grid file> <results file> [threads] [resources directory]" << std::endl;
+		return 1;
+	}
+	const std::string gridFile = argv[1];
+	const std::string resultsFile = argv[2];
+	const unsigned int nThreads = argc > 3 ? std::stoul(argv[3]) : 0;
+	const std::string resourcesDirectory = argc > 4 ? argv[4] : "Resources/";
+
+	FileUtils::getInstance()->addSearchPath(resourcesDirectory);
+
+	// Read grid
+	std::ifstream gridStream(gridFile);
+	if (!gridStream) {
+		std::cerr << "Can't open " << gridFile << std::endl;
+		return 1;
+	}
+	const std::string gridInput((std::istreambuf_iterator<char>(gridStream)), std::istreambuf_iterator<char>());
+	auto grid = readGrid(gridInput);
+	const auto runs = getGridValue(grid, GRID_RUNS_TAG, 1);
+	const auto firstSeed = getGridValue(grid, INPUT_SEED_TAG, 1);
+	grid.erase(std::remove_if(grid.begin(), grid.end(), [](const std::pair<std::string, GridValues>& pair) {
+		return pair.first == GRID_RUNS_TAG || pair.first == INPUT_SEED_TAG;
+	}), grid.end());
+
+	// All combinations of values
+	std::vector<GameSimulationConfig> configs;
+	std::vector<size_t> indices(grid.size(), 0);
+	while (true) {
+		try {
+			configs.push_back(GameSimulation::readConfig(makeInput(grid, indices)));
+		}
+		catch (const std::invalid_argument& e) {
+			std::cerr << "Skipping combination: " << e.what() << std::endl;
+		}
+
+		// Next combination
+		size_t i = 0;
+		for (; i < grid.size(); ++i) {
+			if (++indices[i] < grid[i].second.size())
+				break;
+			indices[i] = 0;
+		}
+		if (i == grid.size())
+			break;
+	}
+	if (configs.empty()) {
+		std::cerr << "No valid combinations in " << gridFile << std::endl;
+		return 1;
+	}
+
+	// Play all games
+	// Results are written into their own slots, so workers don't need locks
+	std::vector<RunResult> results(configs.size() * runs);
+	const auto start = std::chrono::steady_clock::now();
+	{
+		WorkStealingPool pool(nThreads);
+		std::cout << "Playing " << results.size() << " games on " << pool.getThreadCount() << " threads" << std::endl;
+		for (size_t c = 0; c < configs.size(); ++c)
+			for (unsigned int r = 0; r < runs; ++r)
+				pool.submit([&configs, &results, c, r, runs, firstSeed] {
+					auto config = configs[c];
+					config.seed = firstSeed + r;
+					results[c * runs + r] = runGame(config);
+				});
+		pool.wait();
+	}
+	std::cout << "Done in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s" << std::endl;
+
+	// Aggregate and write results
+	std::ofstream resultsStream(resultsFile);
+	if (!resultsStream) {
+		std::cerr << "Can't open " << resultsFile << std::endl;
+		return 1;
+	}
+	resultsStream << INPUT_COUNT_TARGET_TAG << "," << INPUT_PROJECTILE_SPEED_TAG << "," << INPUT_GAME_TIME_TAG << ","
+		<< INPUT_ASTEROID_MAX_SPEED_TAG << "," << INPUT_ASTEROID_MIN_SCALE_TAG << "," << INPUT_ASTEROID_MAX_SCALE_TAG << ","
+		<< INPUT_SEED_TAG << ",Runs,WinRate,MeanTimeToClear,MeanScore,MeanStepMicroseconds,MaxStepMicroseconds\n";
+	for (size_t c = 0; c < configs.size(); ++c) {
+		const auto& config = configs[c];
+		unsigned int wins = 0;
+		unsigned long long steps = 0;
+		double timeToClear = 0;
+		double score = 0;
+		double seconds = 0;
+		double maxStep = 0;
+		for (unsigned int r = 0; r < runs; ++r) {
+			const auto& result = results[c * runs + r];
+			if (result.isWin) {
+				++wins;
+				timeToClear += result.elapsedTime;
+			}
+			score += result.score;
+			steps += result.steps;
+			seconds += result.seconds;
+			maxStep = std::max(maxStep, result.maxStepSeconds);
+		}
+		resultsStream << config.maxScore << "," << config.projectileSpeed << "," << config.maxGameTime << ","
+			<< config.asteroidMaxSpeed << "," << config.asteroidMinScale << "," << config.asteroidMaxScale << ","
+			<< firstSeed << "," << runs << "," << static_cast<double>(wins) / runs << "," << (wins > 0 ? timeToClear / wins : 0) << ","
+			<< score / runs << "," << seconds / steps * 1e6 << "," << maxStep * 1e6 << "\n";
+	}
+
+	return 0;
+}
@@ -0,0 +1,539 @@
+// Checks of game components that don't need a window, a GPU or an audio device
+// Usage: headless_check [filter]
+//
+// Filter runs only checks with names containing it, exit code is 1 if any check failed
+// Checks:
+//   BurstEmission - a burst emits totalParticles or for duration at emissionRate
+//   BurstCap - no more than maxParticles are alive at once
+//   BurstLerp - colors and sizes reach end values at the end of life
+//   BurstRemoveDead - dead particles are removed and the live ones keep their attributes
+//   AudioRateLimit - an effect played again sooner than minInterval is dropped
+//   AudioVoiceBudget - no more than maxVoices effects play at once, finished ones free their voices
+//   AudioStealing - a new effect steals the voice of the lowest priority, the oldest of them
+//   AudioStats - statistics match the calls of the backend
+//   PhysStepNoAllocations - a steady-state physics step doesn't touch heap, needs ALLOCATION_TRACKING
+//   RecordingRoundTrip - a saved and loaded recording replays to the same game
+//   PhysLod - bodies far from focus skip steps but end up where full stepping puts them, their nodes are culled
+
+#include "AudioManager.h"
+#include "BurstParticles.h"
+#include "GameRecording.h"
+#include "Gunship.h"
+#include "Physics/Physics.h"
+#include "Definitions.h"
+#include "AllocationTracker.h"
+#include "GameObject.h"
+#include "TransformSync.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+USING_NS_CC;
+
+#define CHECK_STEP (1.0f / 60)
+#define CHECK_EPSILON 0.02f
+#define CHECK_WORLD_SIZE Size(1920, 1080)
+#define CHECK_N_BODIES 200
+#define CHECK_BODY_RADIUS 30
+#define CHECK_MAX_SPEED 300
+#define CHECK_SEED 1
+#define CHECK_LOD_WORLD_SCALE 4 // world of LOD check is this many screens wide and high
+#define CHECK_LOD_STEPS 120
+
+// Number of failed conditions of all checks
+static unsigned int failures = 0;
+
+// Report failed condition, checks continue to find more failures
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::cout << "  " << __FILE__ << ":" << __LINE__ << ": " << #condition << std::endl; \
+			++failures; \
+		} \
+	} while (false)
+
+// Update particles for time in steps of CHECK_STEP
+static void updateFor(BurstParticles& particles, const float time)
+{
+	for (auto t = 0.0f; t < time - CHECK_STEP / 2; t += CHECK_STEP)
+		particles.update(CHECK_STEP);
+}
+// Same for physics world
+static void updateFor(PhysWorld& world, const float time)
+{
+	for (auto t = 0.0f; t < time - CHECK_STEP / 2; t += CHECK_STEP)
+		world.step(CHECK_STEP);
+}
+
+// Parameters without variances, particles stand still and live for life
+static BurstParams createParams(const float duration, const float emissionRate, const unsigned int totalParticles, const float life)
+{
+	BurstParams params;
+	params.duration = duration;
+	params.emissionRate = emissionRate;
+	params.totalParticles = totalParticles;
+	params.life = life;
+	params.startSize = params.endSize = 10;
+	params.startColor = params.endColor = Color4F::WHITE;
+	return params;
+}
+
+// A burst emits totalParticles or for duration at emissionRate
+static void checkBurstEmission()
+{
+	// Limited by totalParticles
+	BurstParticles total(createParams(1, 100, 30, 10), 1000);
+	total.addBurst(Vec2::ZERO);
+	updateFor(total, 2);
+	CHECK(total.getParticleCount() == 30);
+	CHECK(total.getBurstCount() == 0);
+
+	// Limited by duration, within one step of emission
+	const auto duration = 0.5f;
+	const auto emissionRate = 100.0f;
+	BurstParticles timed(createParams(duration, emissionRate, 1000, 10), 1000);
+	timed.addBurst(Vec2::ZERO);
+	updateFor(timed, 2);
+	CHECK(std::abs(static_cast<float>(timed.getParticleCount()) - duration * emissionRate) <= emissionRate * CHECK_STEP + 1);
+	CHECK(timed.getBurstCount() == 0);
+
+	// Every burst emits on its own
+	BurstParticles twice(createParams(1, 100, 30, 10), 1000);
+	twice.addBurst(Vec2::ZERO);
+	twice.addBurst(Vec2::ONE);
+	updateFor(twice, 2);
+	CHECK(twice.getParticleCount() == 60);
+}
+
+// No more than maxParticles are alive at once
+static void checkBurstCap()
+{
+	const auto maxParticles = 20u;
+	BurstParticles particles(createParams(1, 1000, 30, 10), maxParticles);
+	for (auto i = 0; i < 3; ++i)
+		particles.addBurst(Vec2::ZERO);
+	auto mostParticles = 0u;
+	for (auto i = 0; i < 60; ++i) {
+		particles.update(CHECK_STEP);
+		mostParticles = std::max(mostParticles, particles.getParticleCount());
+	}
+	CHECK(mostParticles == maxParticles);
+	CHECK(particles.getParticleCount() == maxParticles);
+}
+
+// Colors and sizes reach end values at the end of life
+static void checkBurstLerp()
+{
+	const auto life = 1.0f;
+	auto params = createParams(0, 1000, 1, life);
+	params.startColor = Color4F(1, 0.5f, 0, 1);
+	params.endColor = Color4F(0, 0.5f, 1, 0);
+	params.startSize = 10;
+	params.endSize = 30;
+	BurstParticles particles(params, 10);
+	particles.addBurst(Vec2::ZERO);
+
+	// Last step before the particle dies
+	updateFor(particles, life - CHECK_STEP);
+	CHECK(particles.getParticleCount() == 1);
+	if (particles.getParticleCount() == 1) {
+		const auto rest = CHECK_STEP / life;
+		CHECK(std::abs(particles.getColorR()[0] - params.endColor.r) <= rest + CHECK_EPSILON);
+		CHECK(std::abs(particles.getColorG()[0] - params.endColor.g) <= rest + CHECK_EPSILON);
+		CHECK(std::abs(particles.getColorB()[0] - params.endColor.b) <= rest + CHECK_EPSILON);
+		CHECK(std::abs(particles.getColorA()[0] - params.endColor.a) <= rest + CHECK_EPSILON);
+		CHECK(std::abs(particles.getSize()[0] - params.endSize) <= (params.endSize - params.startSize) * (rest + CHECK_EPSILON));
+	}
+	// Rounding of time to live can keep it one more step
+	updateFor(particles, 2 * CHECK_STEP);
+	CHECK(particles.getParticleCount() == 0);
+
+	// Negative end size keeps start size, tint multiplies colors
+	params.endSize = -1;
+	BurstParticles tinted(params, 10);
+	tinted.addBurst(Vec2::ZERO, 1, Color3B(0, 255, 0));
+	updateFor(tinted, life / 2);
+	CHECK(tinted.getParticleCount() == 1);
+	if (tinted.getParticleCount() == 1) {
+		CHECK(tinted.getSize()[0] == params.startSize);
+		CHECK(tinted.getColorR()[0] == 0);
+		CHECK(tinted.getColorB()[0] == 0);
+	}
+}
+
+// Dead particles are removed and the live ones keep their attributes
+static void checkBurstRemoveDead()
+{
+	// Particles fade out, so a dead one left among the live ones has no alpha
+	const auto life = 1.0f;
+	auto params = createParams(0, 1000, 5, life);
+	params.startColor = Color4F(1, 1, 1, 1);
+	params.endColor = Color4F(1, 1, 1, 0);
+	BurstParticles particles(params, 100);
+
+	// Last burst starts while particles of the first ones live, its particles are at the end of arrays
+	const auto first = Vec2(0, 0);
+	const auto last = Vec2(100, 0);
+	particles.addBurst(first);
+	particles.addBurst(first);
+	updateFor(particles, life / 2);
+	particles.addBurst(last);
+	updateFor(particles, life * 0.7f);
+	CHECK(particles.getParticleCount() == 5);
+	for (unsigned int i = 0; i < particles.getParticleCount(); ++i) {
+		CHECK(particles.getOriginX()[i] == last.x);
+		CHECK(particles.getColorA()[i] > 0);
+	}
+
+	updateFor(particles, life);
+	CHECK(particles.getParticleCount() == 0);
+	CHECK(particles.getBurstCount() == 0);
+}
+
+// Manager with a backend that only counts calls
+static AudioManager createAudioManager(const unsigned int maxVoices)
+{
+	return AudioManager(std::make_unique<NullAudioBackend>(), maxVoices);
+}
+
+// Backend of manager created by createAudioManager
+static const NullAudioBackend* getNullBackend(const AudioManager& manager)
+{
+	return static_cast<const NullAudioBackend*>(manager.getBackend());
+}
+
+// An effect played again sooner than minInterval is dropped
+static void checkAudioRateLimit()
+{
+	auto manager = createAudioManager(8);
+	manager.preloadEffect("a", { 0, 0.1f, 0.05f });
+	manager.preloadEffect("b", { 0, 0.1f, 0.05f });
+	CHECK(manager.playEffect("a"));
+	CHECK(!manager.playEffect("a"));
+	// Other effects have their own interval
+	CHECK(manager.playEffect("b"));
+	manager.update(0.05f);
+	CHECK(!manager.playEffect("a"));
+	manager.update(0.06f);
+	CHECK(manager.playEffect("a"));
+	CHECK(manager.getStats().rateLimited == 2);
+}
+
+// No more than maxVoices effects play at once, finished ones free their voices
+static void checkAudioVoiceBudget()
+{
+	const auto maxVoices = 3u;
+	auto manager = createAudioManager(maxVoices);
+	const char* files[] = { "a", "b", "c", "d", "e" };
+	for (auto file : files)
+		manager.preloadEffect(file, { 0, 0, 1 });
+	for (auto file : files) {
+		manager.playEffect(file);
+		CHECK(manager.getVoiceCount() <= maxVoices);
+	}
+	CHECK(manager.getVoiceCount() == maxVoices);
+
+	manager.update(0.5f);
+	CHECK(manager.getVoiceCount() == maxVoices);
+	manager.update(0.5f);
+	CHECK(manager.getVoiceCount() == 0);
+}
+
+// A new effect steals the voice of the lowest priority, the oldest of them
+static void checkAudioStealing()
+{
+	const auto length = 1.0f;
+	auto manager = createAudioManager(2);
+	manager.preloadEffect("low", { 1, 0, length });
+	manager.preloadEffect("high", { 2, 0, length });
+
+	// Lower priority is stolen first even though it's not the oldest
+	CHECK(manager.playEffect("high")); // 0.0
+	manager.update(0.1f);
+	CHECK(manager.playEffect("low")); // 0.1
+	manager.update(0.1f);
+	CHECK(manager.playEffect("high")); // 0.2, steals low
+	CHECK(getNullBackend(manager)->getStopCount() == 1);
+
+	// Higher priority voices aren't stolen
+	CHECK(!manager.playEffect("low"));
+	CHECK(getNullBackend(manager)->getStopCount() == 1);
+
+	// Of equal priorities the oldest is stolen, so the voices of 0.2 and 0.3 are left
+	manager.update(0.1f);
+	CHECK(manager.playEffect("high")); // 0.3, steals 0.0
+	CHECK(getNullBackend(manager)->getStopCount() == 2);
+	manager.update(length - 0.2f); // 1.1, the voice of 0.0 would be finished
+	CHECK(manager.getVoiceCount() == 2);
+	manager.update(0.15f); // 1.25
+	CHECK(manager.getVoiceCount() == 1);
+	manager.update(0.1f); // 1.35
+	CHECK(manager.getVoiceCount() == 0);
+}
+
+// Statistics match the calls of the backend
+static void checkAudioStats()
+{
+	auto manager = createAudioManager(2);
+	manager.preloadEffect("low", { 1, 0.1f, 1 });
+	manager.preloadEffect("high", { 2, 0, 1 });
+	const auto* backend = getNullBackend(manager);
+	CHECK(backend->getPreloadCount() == 2);
+
+	manager.playEffect("low"); // played
+	manager.playEffect("low"); // rate limited
+	manager.playEffect("high"); // played
+	manager.playEffect("high"); // played, steals low
+	manager.update(0.2f);
+	manager.playEffect("low"); // no voice
+	const auto& stats = manager.getStats();
+	CHECK(stats.played == 3);
+	CHECK(stats.rateLimited == 1);
+	CHECK(stats.noVoice == 1);
+	CHECK(stats.stolen == 1);
+	CHECK(stats.played == backend->getPlayCount());
+	CHECK(stats.stolen == backend->getStopCount());
+
+	manager.resetStats();
+	CHECK(manager.getStats().played == 0 && manager.getStats().rateLimited == 0 && manager.getStats().noVoice == 0 && manager.getStats().stolen == 0);
+}
+
+// World of size with edge around it and nBodies asteroid-like bodies flying in random directions
+static std::unique_ptr<PhysWorld> createPhysWorld(const Size& size, const unsigned int nBodies)
+{
+	auto world = std::make_unique<PhysWorld>(-PARTITIONS_OUTSIDE_OFFSET * size, size * (1 + 2 * PARTITIONS_OUTSIDE_OFFSET), CHECK_SEED);
+	auto& random = world->getRandom();
+
+	// Same edge as in the game
+	const auto center = Vec2(size / 2);
+	auto edgeBody = std::make_unique<PhysBody>(center);
+	edgeBody->addCollider(std::make_unique<PhysBoxCollider>(Vec2(0, (size.height + EDGE_WIDTH) / 2), Size(size.width, EDGE_WIDTH), EDGE_BITMASKS));  // top
+	edgeBody->addCollider(std::make_unique<PhysBoxCollider>(Vec2(0, -(size.height + EDGE_WIDTH) / 2), Size(size.width, EDGE_WIDTH), EDGE_BITMASKS)); // bottom
+	edgeBody->addCollider(std::make_unique<PhysBoxCollider>(Vec2((size.width + EDGE_WIDTH) / 2, 0), Size(EDGE_WIDTH, size.height), EDGE_BITMASKS));  // right
+	edgeBody->addCollider(std::make_unique<PhysBoxCollider>(Vec2(-(size.width + EDGE_WIDTH) / 2, 0), Size(EDGE_WIDTH, size.height), EDGE_BITMASKS)); // left
+	world->addBody(std::move(edgeBody));
+
+	for (unsigned int i = 0; i < nBodies; ++i) {
+		const auto position = Vec2(random.next_0_1() * size.width, random.next_0_1() * size.height);
+		const auto speed = Vec2::ONE.rotateByAngle(Vec2::ZERO, random.next_0_1() * CC_DEGREES_TO_RADIANS(360)) * random.next_0_1() * CHECK_MAX_SPEED;
+		auto body = std::make_unique<PhysBody>(position);
+		body->addCollider(std::make_unique<PhysCircleCollider>(CHECK_BODY_RADIUS, ASTEROID_BITMASKS));
+		body->setMovement(std::make_unique<PhysMovement>(speed));
+		world->addBody(std::move(body));
+	}
+	return world;
+}
+
+// A steady-state physics step doesn't touch heap
+static void checkPhysStepNoAllocations()
+{
+	// Without tracking all counts are zeros, so the check would always pass
+	CHECK(ALLOCATION_TRACKING);
+
+	// Containers and pools grow during the first steps
+	auto world = createPhysWorld(CHECK_WORLD_SIZE, CHECK_N_BODIES);
+	updateFor(*world, 5);
+
+	// Bodies keep hitting each other and the edge, so contacts and partitions change
+	auto mostAllocations = uint64_t(0);
+	auto contacts = size_t(0);
+	for (auto i = 0; i < 600; ++i) {
+		const AllocationCounter counter;
+		world->step(CHECK_STEP);
+		mostAllocations = std::max(mostAllocations, counter.getAllocations());
+		contacts += world->getCurrentContacts().size();
+	}
+	CHECK(contacts > 0);
+	CHECK(mostAllocations == 0);
+}
+
+// Play game of config until it's over, input is read from recording if it has steps or recorded otherwise
+static void playGame(GameSimulation& simulation, GameRecording& recording)
+{
+	const auto isReplay = recording.getStepCount() > 0;
+	recording.rewind();
+	for (unsigned int i = 0; simulation.isPlaying(); ++i) {
+		auto dT = CHECK_STEP;
+		GameInput input;
+		if (isReplay) {
+			if (!recording.readStep(dT, input))
+				break;
+		}
+		else {
+			// Autopilot aims and shoots, the gunship also flies around to use all axis values
+			input = simulation.getAutopilotInput();
+			input.axis = Vec2(static_cast<float>(i / 30 % 3) - 1, static_cast<float>(i / 70 % 3) - 1);
+			input.shooting = i / 100 % 4 != 0;
+			recording.addStep(dT, input);
+		}
+		simulation.setInput(input);
+		simulation.step(dT);
+	}
+}
+
+// A saved and loaded recording replays to the same game
+static void checkRecordingRoundTrip()
+{
+	GameSimulationConfig config;
+	config.maxScore = 20;
+	config.projectileSpeed = 500;
+	config.maxGameTime = 20;
+	config.seed = CHECK_SEED;
+
+	GameRecording recording(config);
+	GameSimulation played(config);
+	playGame(played, recording);
+	CHECK(!played.isPlaying());
+
+	auto loaded = GameRecording::deserialize(recording.serialize());
+	CHECK(loaded.getStepCount() == recording.getStepCount());
+	CHECK(loaded.getConfig().seed == config.seed);
+	GameSimulation replayed(loaded.getConfig());
+	playGame(replayed, loaded);
+	CHECK(!replayed.isPlaying());
+	CHECK(replayed.getScore() == played.getScore());
+	CHECK(replayed.getGameTime() == played.getGameTime());
+	CHECK(replayed.getElapsedTime() == played.getElapsedTime());
+	CHECK(replayed.getGunship()->getPosition() == played.getGunship()->getPosition());
+
+	// Data that isn't a recording is rejected
+	auto rejected = false;
+	try {
+		GameRecording::deserialize("GREC");
+	}
+	catch (const std::invalid_argument&) {
+		rejected = true;
+	}
+	CHECK(rejected);
+}
+
+// Game object without sprites that counts its steps and shows if its node is culled
+class CountingObject : public GameObject
+{
+public:
+	virtual void step(const float dT) override
+	{
+		GameObject::step(dT);
+		++stepCount_;
+	}
+
+	unsigned int getStepCount() const { return stepCount_; }
+	bool isNodeVisible() const { return rootNode_ && rootNode_->isVisible(); }
+
+	explicit CountingObject(const Vec2& pos) : GameObject(pos) {}
+
+private:
+	unsigned int stepCount_ = 0;
+};
+
+// World much larger than the screen with objects flying in random directions
+// Objects have no colliders, so the only difference between full and LOD stepping is when they step
+static std::unique_ptr<PhysWorld> createLodWorld(const Size& size, const unsigned int nObjects, Scene* scene, std::vector<CountingObject*>& objects)
+{
+	auto world = std::make_unique<PhysWorld>(Vec2::ZERO, size, CHECK_SEED);
+	auto& random = world->getRandom();
+	for (unsigned int i = 0; i < nObjects; ++i) {
+		const auto position = Vec2(random.next_0_1() * size.width, random.next_0_1() * size.height);
+		const auto speed = Vec2::ONE.rotateByAngle(Vec2::ZERO, random.next_0_1() * CC_DEGREES_TO_RADIANS(360)) * (0.5f + random.next_0_1() / 2) * CHECK_MAX_SPEED;
+		auto object = std::make_unique<CountingObject>(position);
+		object->setMovement(std::make_unique<PhysMovement>(speed));
+		if (scene)
+			object->addToScene(scene);
+		objects.push_back(object.get());
+		world->addBody(std::move(object));
+	}
+	return world;
+}
+
+// Bodies far from focus skip steps but end up where full stepping puts them, their nodes are culled
+static void checkPhysLod()
+{
+	const auto size = CHECK_WORLD_SIZE * CHECK_LOD_WORLD_SCALE;
+	const auto focus = Rect(Vec2(size / 2) - Vec2(CHECK_WORLD_SIZE / 2), CHECK_WORLD_SIZE);
+
+	std::vector<CountingObject*> fullObjects;
+	auto fullWorld = createLodWorld(size, CHECK_N_BODIES, nullptr, fullObjects);
+	const auto scene = Scene::create();
+	std::vector<CountingObject*> lodObjects;
+	auto lodWorld = createLodWorld(size, CHECK_N_BODIES, scene, lodObjects);
+	lodWorld->setFocus(focus);
+	for (auto i = 0; i < CHECK_LOD_STEPS; ++i) {
+		fullWorld->step(CHECK_STEP);
+		lodWorld->step(CHECK_STEP);
+	}
+
+	// Objects that couldn't leave focus step every step, far ones less often, with all the time they waited
+	const auto travel = CHECK_MAX_SPEED * CHECK_LOD_STEPS * CHECK_STEP;
+	const auto inner = Rect(focus.origin + Vec2(travel, travel), focus.size - Size(travel, travel) * 2);
+	auto skipped = 0u;
+	for (size_t i = 0; i < lodObjects.size(); ++i) {
+		const auto lod = lodObjects[i];
+		const auto full = fullObjects[i];
+		if (inner.containsPoint(lod->getPosition()))
+			CHECK(lod->getStepCount() == CHECK_LOD_STEPS);
+		if (lod->getStepCount() < CHECK_LOD_STEPS)
+			++skipped;
+
+		const auto expected = full->getPosition() - full->getMovement()->getSpeed() * lod->getPendingTime();
+		CHECK(lod->getPosition().distance(expected) < 1);
+	}
+	CHECK(skipped > lodObjects.size() / 2);
+
+	// Nodes outside the view are culled
+	const auto sync = TransformSync::getFor(scene);
+	sync->setViewRect(focus);
+	sync->flush(1);
+	auto culled = 0u;
+	for (auto object : lodObjects) {
+		CHECK(object->isNodeVisible() == sync->isInView(object->getPosition()));
+		if (!object->isNodeVisible())
+			++culled;
+	}
+	CHECK(culled > lodObjects.size() / 2);
+}
+
+int main(int argc, char** argv)
+{
+	const std::string filter = argc > 1 ? argv[1] : "";
+
+	// All checks
+	const std::vector<std::pair<std::string, std::function<void()>>> checks = {
+		{ "BurstEmission", checkBurstEmission },
+		{ "BurstCap", checkBurstCap },
+		{ "BurstLerp", checkBurstLerp },
+		{ "BurstRemoveDead", checkBurstRemoveDead },
+		{ "AudioRateLimit", checkAudioRateLimit },
+		{ "AudioVoiceBudget", checkAudioVoiceBudget },
+		{ "AudioStealing", checkAudioStealing },
+		{ "AudioStats", checkAudioStats },
+		{ "PhysStepNoAllocations", checkPhysStepNoAllocations },
+		{ "RecordingRoundTrip", checkRecordingRoundTrip },
+		{ "PhysLod", checkPhysLod }
+	};
+
+	unsigned int failedChecks = 0;
+	for (const auto& check : checks) {
+		if (check.first.find(filter) == std::string::npos)
+			continue;
+
+		const auto failuresBefore = failures;
+		check.second();
+		if (failures == failuresBefore) {
+			std::cout << "OK    " << check.first << std::endl;
+		}
+		else {
+			std::cout << "FAIL  " << check.first << std::endl;
+			++failedChecks;
+		}
+	}
+
+	if (failedChecks > 0) {
+		std::cout << failedChecks << " checks failed" << std::endl;
+		return 1;
+	}
+	return 0;
+}
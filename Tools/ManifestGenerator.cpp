@@ -0,0 +1,246 @@
+// Generates SpriteManifestData.h, the table of sprites read by SpriteManifest, and packs gameplay sprites into an atlas
+// Usage: manifest_generator <output header> <resources directory> <sprite files...> [--atlas <atlas file> <output resources directory> <atlas sprite files...>]
+//        manifest_generator --compare <png file> <png file>
+//
+// The build runs it whenever a sprite changes, sprites are the *.png files of Resources/sprites
+// Atlas file is relative to resources (e.g. atlases/Gameplay.png), it's written into the output resources directory
+// Atlas sprites have to be among the sprites
+// Sizes are read from PNG headers, only atlas sprites are decoded
+// Atlas sprites are packed into shelves, tallest first, with edges repeated into ATLAS_PADDING so that filtering doesn't bleed neighbors
+// Their manifest entries point to the atlas, others to their own files
+// Output is sorted by path, the build writes it and the atlas into the build directory
+// Copies of generated files are committed for builds that don't run tools (Android, iOS, Visual Studio project)
+// --compare exits with 1 if two images have different sizes or pixels, the build uses it to check the committed atlas
+
+#include "cocos2d.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+USING_NS_CC;
+
+#define ATLAS_PADDING 2 // around every sprite
+#define ATLAS_MAX_SIZE 2048 // supported by all GPUs we run on
+
+// Sprite as written to the table
+struct SpriteEntry
+{
+	std::string file; // relative to resources
+	unsigned int width;
+	unsigned int height;
+	std::string texture; // relative to resources
+	unsigned int x = 0; // in texture
+	unsigned int y = 0;
+};
+
+// Return directory path with '/' separators and a '/' at the end
+static std::string toDirectory(std::string path)
+{
+	std::replace(path.begin(), path.end(), '\\', '/');
+	if (path.empty() || path.back() != '/')
+		path += '/';
+	return path;
+}
+
+// Return path relative to root, throws invalid_argument if it isn't in root
+static std::string getRelativePath(std::string path, const std::string& root)
+{
+	std::replace(path.begin(), path.end(), '\\', '/');
+	if (path.compare(0, root.size(), root) != 0)
+		throw std::invalid_argument(path + " is not in " + root);
+	return path.substr(root.size());
+}
+
+// Read width and height from the PNG header of file
+// Signature (8 bytes), IHDR length and type (8 bytes), width and height (4 bytes each)
+static void readSize(const std::string& path, SpriteEntry& sprite)
+{
+	std::ifstream stream(path, std::ios::binary);
+	unsigned char bytes[24];
+	if (!stream.read(reinterpret_cast<char*>(bytes), sizeof(bytes)) || bytes[1] != 'P' || bytes[2] != 'N' || bytes[3] != 'G')
+		throw std::invalid_argument(path + " is not a png file");
+
+	const auto readUInt = [&bytes](const unsigned int offset) {
+		return (static_cast<unsigned int>(bytes[offset]) << 24) | (bytes[offset + 1] << 16) | (bytes[offset + 2] << 8) | bytes[offset + 3];
+	};
+	sprite.width = readUInt(16);
+	sprite.height = readUInt(20);
+}
+
+// Return smallest power of two that is at least value
+static unsigned int nextPowerOfTwo(const unsigned int value)
+{
+	unsigned int power = 1;
+	while (power < value)
+		power *= 2;
+	return power;
+}
+
+// Place sprites into shelves of an atlas of width, returns used height
+static unsigned int placeInShelves(const std::vector<SpriteEntry*>& sprites, const unsigned int width)
+{
+	unsigned int x = 0;
+	unsigned int y = 0;
+	unsigned int shelfHeight = 0;
+	for (auto sprite : sprites) {
+		const auto cellWidth = sprite->width + 2 * ATLAS_PADDING;
+		const auto cellHeight = sprite->height + 2 * ATLAS_PADDING;
+		if (x + cellWidth > width) {
+			y += shelfHeight;
+			x = 0;
+			shelfHeight = 0;
+		}
+		sprite->x = x + ATLAS_PADDING;
+		sprite->y = y + ATLAS_PADDING;
+		x += cellWidth;
+		shelfHeight = std::max(shelfHeight, cellHeight);
+	}
+	return y + shelfHeight;
+}
+
+// Pack sprites of root into atlas file in output root and point them to it
+static void packAtlas(std::vector<SpriteEntry*> sprites, const std::string& root, const std::string& atlasFile, const std::string& outputRoot)
+{
+	// Tallest first, ties by file, so that the layout doesn't depend on order of arguments
+	std::sort(sprites.begin(), sprites.end(), [](const SpriteEntry* a, const SpriteEntry* b) {
+		return a->height != b->height ? a->height > b->height : a->file < b->file;
+	});
+
+	// Narrowest power of two width that makes the atlas not taller than wide
+	unsigned int width = 1;
+	for (auto sprite : sprites)
+		width = std::max(width, nextPowerOfTwo(sprite->width + 2 * ATLAS_PADDING));
+	auto height = placeInShelves(sprites, width);
+	while (height > width && width < ATLAS_MAX_SIZE) {
+		width *= 2;
+		height = placeInShelves(sprites, width);
+	}
+	height = nextPowerOfTwo(height);
+	if (width > ATLAS_MAX_SIZE || height > ATLAS_MAX_SIZE)
+		throw std::invalid_argument("atlas sprites don't fit into " + std::to_string(ATLAS_MAX_SIZE) + " pixels");
+
+	// Copy images, padding repeats their edges
+	Image::setPNGPremultipliedAlphaEnabled(false); // pixels are saved as they are in the files
+	std::vector<unsigned char> pixels(width * height * 4, 0);
+	for (auto sprite : sprites) {
+		Image image;
+		if (!image.initWithImageFile(root + sprite->file) || image.getRenderFormat() != Texture2D::PixelFormat::RGBA8888)
+			throw std::invalid_argument(sprite->file + " has to be an RGBA png");
+		const auto data = image.getData();
+		const auto spriteWidth = static_cast<int>(sprite->width);
+		const auto spriteHeight = static_cast<int>(sprite->height);
+		for (auto y = -ATLAS_PADDING; y < spriteHeight + ATLAS_PADDING; ++y) {
+			const auto sourceY = std::min(std::max(y, 0), spriteHeight - 1);
+			for (auto x = -ATLAS_PADDING; x < spriteWidth + ATLAS_PADDING; ++x) {
+				const auto sourceX = std::min(std::max(x, 0), spriteWidth - 1);
+				const auto target = (static_cast<int>(sprite->y) + y) * static_cast<int>(width) + static_cast<int>(sprite->x) + x;
+				std::memcpy(&pixels[target * 4], data + (sourceY * spriteWidth + sourceX) * 4, 4);
+			}
+		}
+		sprite->texture = atlasFile;
+	}
+
+	const auto atlasPath = outputRoot + atlasFile;
+	FileUtils::getInstance()->createDirectory(atlasPath.substr(0, atlasPath.rfind('/') + 1));
+	Image atlas;
+	if (!atlas.initWithRawData(pixels.data(), pixels.size(), width, height, 8, false) || !atlas.saveToFile(atlasPath, false))
+		throw std::invalid_argument("can't write " + atlasPath);
+	std::cout << "Packed " << sprites.size() << " sprites into " << atlasPath << " (" << width << "x" << height << ")" << std::endl;
+}
+
+// Return whether two images have the same size and pixels, throws invalid_argument if one can't be read
+// Files are compared decoded, so that images saved by different versions of libpng and zlib are equal
+static bool compareImages(const std::string& pathA, const std::string& pathB)
+{
+	Image::setPNGPremultipliedAlphaEnabled(false);
+	Image a, b;
+	if (!a.initWithImageFile(pathA))
+		throw std::invalid_argument("can't read " + pathA);
+	if (!b.initWithImageFile(pathB))
+		throw std::invalid_argument("can't read " + pathB);
+	return a.getWidth() == b.getWidth() && a.getHeight() == b.getHeight() && a.getRenderFormat() == b.getRenderFormat()
+		&& a.getDataLen() == b.getDataLen() && std::memcmp(a.getData(), b.getData(), static_cast<size_t>(a.getDataLen())) == 0;
+}
+
+// Return the table as C++
+static std::string writeTable(const std::vector<SpriteEntry>& sprites)
+{
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(1); // radii are halves of integers
+	out << "// Generated by manifest_generator from Resources/sprites, don't edit\n";
+	out << "// { file, width, height, collider radius, texture, x and y in texture }\n\n";
+	for (const auto& sprite : sprites)
+		out << "{ \"" << sprite.file << "\", " << sprite.width << ", " << sprite.height << ", " << sprite.width / 2.0f << "f, \""
+			<< sprite.texture << "\", " << sprite.x << ", " << sprite.y << " },\n";
+	return out.str();
+}
+
+int main(int argc, char** argv)
+{
+	if (argc == 4 && std::string(argv[1]) == "--compare") {
+		try {
+			if (compareImages(argv[2], argv[3]))
+				return 0;
+			std::cerr << argv[2] << " and " << argv[3] << " are different" << std::endl;
+		}
+		catch (const std::exception& e) {
+			std::cerr << e.what() << std::endl;
+		}
+		return 1;
+	}
+	if (argc < 4) {
+		std::cerr << "Usage: manifest_generator <output header> <resources directory> <sprite files...> [--atlas <atlas file> <output resources directory> <atlas sprite files...>]" << std::endl;
+		std::cerr << "       manifest_generator --compare <png file> <png file>" << std::endl;
+		return 1;
+	}
+	const std::string output = argv[1];
+	const auto root = toDirectory(argv[2]);
+
+	std::vector<SpriteEntry> sprites;
+	try {
+		auto i = 3;
+		for (; i < argc && std::string(argv[i]) != "--atlas"; ++i) {
+			SpriteEntry sprite;
+			sprite.file = getRelativePath(argv[i], root);
+			sprite.texture = sprite.file;
+			readSize(argv[i], sprite);
+			sprites.push_back(sprite);
+		}
+		// SpriteManifest binary searches the table
+		std::sort(sprites.begin(), sprites.end(), [](const SpriteEntry& a, const SpriteEntry& b) { return a.file < b.file; });
+
+		if (i < argc) {
+			if (i + 2 >= argc)
+				throw std::invalid_argument("--atlas needs an atlas file and an output resources directory");
+			const std::string atlasFile = argv[i + 1];
+			const auto outputRoot = toDirectory(argv[i + 2]);
+			std::vector<SpriteEntry*> atlasSprites;
+			for (i += 3; i < argc; ++i) {
+				const auto file = getRelativePath(argv[i], root);
+				const auto foundIt = std::find_if(sprites.begin(), sprites.end(), [&file](const SpriteEntry& sprite) { return sprite.file == file; });
+				if (foundIt == sprites.end())
+					throw std::invalid_argument(file + " is not among the sprites");
+				atlasSprites.push_back(&*foundIt);
+			}
+			packAtlas(atlasSprites, root, atlasFile, outputRoot);
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	std::ofstream stream(output, std::ios::binary);
+	if (!(stream << writeTable(sprites))) {
+		std::cerr << "Can't write " << output << std::endl;
+		return 1;
+	}
+	std::cout << "Wrote " << sprites.size() << " sprites to " << output << std::endl;
+	return 0;
+}
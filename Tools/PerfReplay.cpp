@@ -0,0 +1,218 @@
+// Replays recorded games headless and measures time of every physics step phase
+// Fails if 99th percentile of step time got worse than baseline by more than threshold
+// Usage: perf_replay [--write-baseline] <recordings directory> <baseline file> [threshold] [resources directory]
+//        perf_replay --record <recordings directory> <games> [resources directory]
+//
+// Every *.rec file of the directory (better given as absolute path) is replayed, e.g. lastGame.rec of a player or games recorded with --record
+// Baseline file has the same format as input.txt: 99th percentiles of step and its phases in microseconds
+// Fails if baseline file doesn't exist, --write-baseline writes it from this run instead of comparing
+// Built with ALLOCATION_TRACKING=1 it also reports allocations per step, steady-state step should make none
+// Threshold is relative, 0.1 means that step can be 10% slower than baseline
+// --record plays games with autopilot and records them, seeds of games are 1, 2, ...
+
+#include "GameRecording.h"
+#include "Physics/Physics.h"
+#include "Definitions.h"
+#include "AllocationTracker.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+USING_NS_CC;
+
+// Baseline tag of the whole step, phases use their names
+#define BASELINE_STEP_TAG "Step"
+#define DEFAULT_THRESHOLD 0.1
+
+// Times of all steps of all replays (in microseconds)
+struct ReplayTimes
+{
+	std::vector<double> steps;
+	std::vector<double> phases[N_PHYS_PHASES];
+	// Allocations of all steps and the worst step (if allocation tracking is enabled)
+	uint64_t allocations = 0;
+	uint64_t maxStepAllocations = 0;
+};
+
+// Return percentile of values, reorders values
+static double getPercentile(std::vector<double>& values, const double percentile)
+{
+	if (values.empty())
+		return 0;
+	const auto index = std::min(values.size() - 1, static_cast<size_t>(percentile * values.size()));
+	std::nth_element(values.begin(), values.begin() + index, values.end());
+	return values[index];
+}
+
+// Return all recordings in directory sorted by name
+static std::vector<std::string> getRecordingFiles(const std::string& directory)
+{
+	auto files = FileUtils::getInstance()->listFiles(directory);
+	files.erase(std::remove_if(files.begin(), files.end(), [](const std::string& file) {
+		return FileUtils::getInstance()->getFileExtension(file) != ".rec";
+	}), files.end());
+	std::sort(files.begin(), files.end());
+	return files;
+}
+
+// Replay one recording and add times of its steps
+static void replay(GameRecording& recording, ReplayTimes& times)
+{
+	GameSimulation simulation(recording.getConfig());
+	recording.rewind();
+	float dT;
+	GameInput input;
+	while (simulation.isPlaying() && recording.readStep(dT, input)) {
+		simulation.setInput(input);
+		const AllocationCounter counter;
+		const auto start = std::chrono::steady_clock::now();
+		simulation.step(dT);
+		times.steps.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+		times.allocations += counter.getAllocations();
+		times.maxStepAllocations = std::max(times.maxStepAllocations, counter.getAllocations());
+
+		const auto& profile = simulation.getWorld()->getLastStepProfile();
+		for (size_t i = 0; i < N_PHYS_PHASES; ++i)
+			times.phases[i].push_back(profile.phaseTimes[i]);
+	}
+}
+
+// Read baseline file: tag -> value
+static std::map<std::string, double> readBaseline(const std::string& file)
+{
+	std::map<std::string, double> baseline;
+	std::ifstream stream(file);
+	std::string line;
+	while (std::getline(stream, line)) {
+		std::stringstream lineStream(line);
+		std::string tag;
+		double value;
+		if (std::getline(lineStream, tag, '=') && lineStream >> value)
+			baseline[tag] = value;
+	}
+	return baseline;
+}
+
+// Play games with autopilot and record them
+static int record(const std::string& directory, const unsigned int nGames)
+{
+	auto config = GameSimulation::readConfig(FileUtils::getInstance()->getStringFromFile(INPUT_FILE));
+	for (unsigned int seed = 1; seed <= nGames; ++seed) {
+		config.seed = seed;
+		GameRecording recording(config);
+		GameSimulation simulation(config);
+		while (simulation.isPlaying()) {
+			const auto input = simulation.getAutopilotInput();
+			recording.addStep(PHYSICS_UPDATE_INTERVAL, input);
+			simulation.setInput(input);
+			simulation.step(PHYSICS_UPDATE_INTERVAL);
+		}
+
+		const auto file = directory + "/autopilot" + std::to_string(seed) + ".rec";
+		std::ofstream stream(file, std::ios::binary);
+		if (!stream) {
+			std::cerr << "Can't open " << file << std::endl;
+			return 1;
+		}
+		stream << recording.serialize();
+		std::cout << "Recorded " << file << ": " << recording.getStepCount() << " steps" << std::endl;
+	}
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc >= 4 && std::string(argv[1]) == "--record") {
+		FileUtils::getInstance()->addSearchPath(argc > 4 ? argv[4] : "Resources/");
+		return record(argv[2], std::stoul(argv[3]));
+	}
+	const auto writeBaseline = argc > 1 && std::string(argv[1]) == "--write-baseline";
+	const auto first = writeBaseline ? 2 : 1; // index of the first positional argument
+	if (argc < first + 2) {
+		std::cerr << "Usage: " << argv[0] << " [--write-baseline] <recordings directory> <baseline file> [threshold] [resources directory]" << std::endl;
+		std::cerr << "       " << argv[0] << " --record <recordings directory> <games> [resources directory]" << std::endl;
+		return 1;
+	}
+	const std::string directory = argv[first];
+	const std::string baselineFile = argv[first + 1];
+	const auto threshold = argc > first + 2 ? std::stod(argv[first + 2]) : DEFAULT_THRESHOLD;
+	FileUtils::getInstance()->addSearchPath(argc > first + 3 ? argv[first + 3] : "Resources/");
+
+#if !PHYS_PROFILING
+	std::cerr << "Warning: built without PHYS_PROFILING, phase times are zeros" << std::endl;
+#endif
+
+	// Replay everything
+	const auto files = getRecordingFiles(directory);
+	if (files.empty()) {
+		std::cerr << "No recordings in " << directory << std::endl;
+		return 1;
+	}
+	ReplayTimes times;
+	for (const auto& file : files) {
+		// Read directly, FileUtils would look for relative paths in resources
+		std::ifstream stream(file, std::ios::binary);
+		const std::string data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+		try {
+			auto recording = GameRecording::deserialize(data);
+			replay(recording, times);
+			std::cout << "Replayed " << file << ": " << recording.getStepCount() << " steps" << std::endl;
+		}
+		catch (const std::invalid_argument& e) {
+			std::cerr << "Can't replay " << file << ": " << e.what() << std::endl;
+			return 1;
+		}
+	}
+
+#if ALLOCATION_TRACKING
+	std::cout << std::fixed << std::setprecision(2) << "Allocations per step: " << static_cast<double>(times.allocations) / times.steps.size()
+		<< " on average, " << times.maxStepAllocations << " at most" << std::endl;
+#endif
+
+	// 99th percentiles
+	std::vector<std::pair<std::string, double>> results;
+	results.emplace_back(BASELINE_STEP_TAG, getPercentile(times.steps, 0.99));
+	for (size_t i = 0; i < N_PHYS_PHASES; ++i)
+		results.emplace_back(PhysStepProfile::getPhaseName(static_cast<PhysPhase>(i)), getPercentile(times.phases[i], 0.99));
+
+	// This run is the baseline
+	if (writeBaseline) {
+		std::ofstream stream(baselineFile);
+		if (!stream) {
+			std::cerr << "Can't open " << baselineFile << std::endl;
+			return 1;
+		}
+		for (const auto& result : results)
+			stream << result.first << "=" << result.second << "\n";
+		std::cout << "Baseline written to " << baselineFile << std::endl;
+		return 0;
+	}
+
+	// Without baseline nothing can be compared, a check that passes anyway would hide regressions
+	const auto baseline = readBaseline(baselineFile);
+	if (baseline.find(BASELINE_STEP_TAG) == baseline.end()) {
+		std::cerr << "No baseline in " << baselineFile << ", write it with --write-baseline" << std::endl;
+		return 1;
+	}
+
+	// Compare to baseline
+	// Only the whole step can fail, phases are too short to be stable and are just reported
+	std::cout << std::fixed << std::setprecision(2) << "p99 of " << times.steps.size() << " steps (microseconds):" << std::endl;
+	for (const auto& result : results) {
+		const auto found = baseline.find(result.first);
+		std::cout << "  " << std::setw(12) << std::left << result.first << std::right << std::setw(10) << result.second;
+		if (found != baseline.end())
+			std::cout << "  baseline " << std::setw(10) << found->second;
+		std::cout << std::endl;
+	}
+	const auto stepBaseline = baseline.at(BASELINE_STEP_TAG);
+	if (results.front().second > stepBaseline * (1 + threshold)) {
+		std::cerr << "Step time regressed by more than " << threshold * 100 << "%" << std::endl;
+		return 1;
+	}
+	return 0;
+}
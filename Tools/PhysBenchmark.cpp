@@ -0,0 +1,312 @@
+// Benchmarks of physics scaling: worlds of 100 to 100000 circle bodies with asteroids and laser balls
+// Usage: phys_benchmark [filter] [min seconds per benchmark] [max number of bodies]
+//
+// Names are <what>/<distribution>/<number of bodies>, filter runs only benchmarks with names containing it
+// Distributions:
+//   Uniform - bodies anywhere in the world
+//   Clustered - bodies in a few dense clusters
+//   Corridor - bodies in a narrow horizontal band
+// Benchmarks:
+//   Step - whole PhysWorld::step
+//   StepFocused - whole PhysWorld::step with focus on one screen in the middle, so bodies out of it step less often
+//   Intersects - PhysContactEvaluator::intersects on pairs of neighbouring bodies
+//   RemoveBurst - removal phase of the step after removing 1% of bodies at once, only in phys_benchmark_profiled
+//   ManipulatedChurn - onManipulatedBody after deactivating and activating 1% of bodies
+// World size grows with number of bodies, so density is always the same as in a typical level
+// phys_benchmark is built without PHYS_PROFILING, phys_benchmark_profiled with it, so its times include profiler overhead
+
+#include "Physics/Physics.h"
+#include "Definitions.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+USING_NS_CC;
+
+// World parameters
+#define BENCHMARK_SCREEN_SIZE Size(1920, 1080)
+#define BENCHMARK_BODIES_PER_SCREEN 100
+#define BENCHMARK_ASTEROID_RADIUS 30
+#define BENCHMARK_LASER_BALL_RADIUS 8
+#define BENCHMARK_LASER_BALL_SHARE 0.1 // rest are asteroids
+#define BENCHMARK_MAX_SPEED 200
+#define BENCHMARK_N_CLUSTERS 8
+#define BENCHMARK_CLUSTER_SIZE 0.1 // based on world width
+#define BENCHMARK_CORRIDOR_SIZE 0.1 // based on world height
+#define BENCHMARK_SEED 1
+#define BENCHMARK_BURST_SHARE 0.01
+#define BENCHMARK_N_NEIGHBOURS 4
+#define DEFAULT_MIN_SECONDS 0.5
+
+// Results of benchmarks are written here, so that the optimizer can't drop the work
+static volatile unsigned int benchmarkSink;
+
+// How bodies are placed in the world
+enum class Distribution { UNIFORM, CLUSTERED, CORRIDOR };
+
+// Controls iterations and timing of one benchmark
+// Time from the first call of keepRunning() to the last one is measured, unless time is added manually
+class BenchmarkState
+{
+public:
+	// Returns true while there are iterations left
+	bool keepRunning()
+	{
+		if (done_ == 0)
+			start_ = std::chrono::steady_clock::now();
+		if (done_ < iterations_) {
+			++done_;
+			return true;
+		}
+		if (!manual_)
+			seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+		return false;
+	}
+
+	// Use manually measured time instead, e.g. one phase of the step
+	void addManualTime(const double seconds) { manual_ = true; seconds_ += seconds; }
+
+	// Number of items processed in all iterations, used for throughput
+	void addItemsProcessed(const unsigned long long items) { items_ += items; }
+
+	unsigned long long getIterations() const { return iterations_; }
+	double getSeconds() const { return seconds_; }
+	unsigned long long getItemsProcessed() const { return items_; }
+
+	explicit BenchmarkState(const unsigned long long iterations) : iterations_(iterations) {}
+
+private:
+	unsigned long long iterations_;
+	unsigned long long done_ = 0;
+	double seconds_ = 0;
+	bool manual_ = false;
+	unsigned long long items_ = 0;
+	std::chrono::steady_clock::time_point start_;
+};
+
+// World with bodies for benchmarks
+struct BenchmarkWorld
+{
+	std::unique_ptr<PhysWorld> world;
+	// All bodies except edge
+	std::vector<PhysBody*> bodies;
+	// Bodies are between zero and size
+	Size size;
+};
+
+// Name of distribution for reports
+static const char* getDistributionName(const Distribution distribution)
+{
+	switch (distribution) {
+	case Distribution::UNIFORM: return "Uniform";
+	case Distribution::CLUSTERED: return "Clustered";
+	default: return "Corridor";
+	}
+}
+
+// Create world with nBodies circle bodies and edge around it
+static BenchmarkWorld createWorld(const Distribution distribution, const unsigned int nBodies)
+{
+	const auto size = BENCHMARK_SCREEN_SIZE * std::sqrt(static_cast<float>(nBodies) / BENCHMARK_BODIES_PER_SCREEN);
+	const auto center = Vec2(size / 2);
+
+	BenchmarkWorld result;
+	result.size = size;
+	result.world = std::make_unique<PhysWorld>(-PARTITIONS_OUTSIDE_OFFSET * size, size * (1 + 2 * PARTITIONS_OUTSIDE_OFFSET), BENCHMARK_SEED);
+	auto& random = result.world->getRandom();
+
+	// Same edge as in the game
+	auto edgeBody = std::make_unique<PhysBody>(center);
+	edgeBody->addCollider(std::make_unique<PhysBoxCollider>(Vec2(0, (size.height + EDGE_WIDTH) / 2), Size(size.width, EDGE_WIDTH), EDGE_BITMASKS));  // top
+	edgeBody->addCollider(std::make_unique<PhysBoxCollider>(Vec2(0, -(size.height + EDGE_WIDTH) / 2), Size(size.width, EDGE_WIDTH), EDGE_BITMASKS)); // bottom
+	edgeBody->addCollider(std::make_unique<PhysBoxCollider>(Vec2((size.width + EDGE_WIDTH) / 2, 0), Size(EDGE_WIDTH, size.height), EDGE_BITMASKS));  // right
+	edgeBody->addCollider(std::make_unique<PhysBoxCollider>(Vec2(-(size.width + EDGE_WIDTH) / 2, 0), Size(EDGE_WIDTH, size.height), EDGE_BITMASKS)); // left
+	result.world->addBody(std::move(edgeBody));
+
+	std::vector<Vec2> clusters(BENCHMARK_N_CLUSTERS);
+	for (auto& cluster : clusters)
+		cluster = Vec2(random.next_0_1() * size.width, random.next_0_1() * size.height);
+
+	result.bodies.reserve(nBodies);
+	for (unsigned int i = 0; i < nBodies; ++i) {
+		Vec2 position;
+		switch (distribution) {
+		case Distribution::UNIFORM:
+			position = Vec2(random.next_0_1() * size.width, random.next_0_1() * size.height);
+			break;
+		case Distribution::CLUSTERED: {
+			// Sum of uniform numbers is close to normal distribution
+			const auto offset = Vec2(random.next_minus1_1() + random.next_minus1_1() + random.next_minus1_1(),
+				random.next_minus1_1() + random.next_minus1_1() + random.next_minus1_1()) / 3;
+			position = clusters[random.nextBelow(BENCHMARK_N_CLUSTERS)] + offset * BENCHMARK_CLUSTER_SIZE * size.width;
+			break;
+		}
+		case Distribution::CORRIDOR:
+			position = Vec2(random.next_0_1() * size.width, (0.5f + random.next_minus1_1() * BENCHMARK_CORRIDOR_SIZE / 2) * size.height);
+			break;
+		}
+		position.clamp(Vec2::ZERO, Vec2(size));
+
+		const auto speed = Vec2::ONE.rotateByAngle(Vec2::ZERO, random.next_0_1() * CC_DEGREES_TO_RADIANS(360)) * random.next_0_1() * BENCHMARK_MAX_SPEED;
+		auto body = std::make_unique<PhysBody>(position);
+		if (random.next_0_1() < BENCHMARK_LASER_BALL_SHARE)
+			body->addCollider(std::make_unique<PhysCircleCollider>(BENCHMARK_LASER_BALL_RADIUS, LASER_BALL_BITMASKS));
+		else
+			body->addCollider(std::make_unique<PhysCircleCollider>(BENCHMARK_ASTEROID_RADIUS, ASTEROID_BITMASKS));
+		body->setMovement(std::make_unique<PhysMovement>(speed));
+		result.bodies.push_back(body.get());
+		result.world->addBody(std::move(body));
+	}
+
+	// First step puts everything into partitions and finds initial contacts
+	result.world->step(PHYSICS_UPDATE_INTERVAL);
+	return result;
+}
+
+// Whole step
+static void benchmarkStep(BenchmarkState& state, const Distribution distribution, const unsigned int nBodies)
+{
+	auto world = createWorld(distribution, nBodies);
+	while (state.keepRunning()) {
+		world.world->step(PHYSICS_UPDATE_INTERVAL);
+		state.addItemsProcessed(nBodies);
+	}
+}
+
+// Whole step when only one screen of the world is in focus, like in a level larger than the screen
+static void benchmarkStepFocused(BenchmarkState& state, const Distribution distribution, const unsigned int nBodies)
+{
+	auto world = createWorld(distribution, nBodies);
+	world.world->setFocus(Rect(Vec2(world.size / 2) - Vec2(BENCHMARK_SCREEN_SIZE / 2), BENCHMARK_SCREEN_SIZE));
+	while (state.keepRunning()) {
+		world.world->step(PHYSICS_UPDATE_INTERVAL);
+		state.addItemsProcessed(nBodies);
+	}
+}
+
+// Contact tests of neighbouring bodies
+static void benchmarkIntersects(BenchmarkState& state, const Distribution distribution, const unsigned int nBodies)
+{
+	auto world = createWorld(distribution, nBodies);
+	auto bodies = world.bodies;
+	std::sort(bodies.begin(), bodies.end(), [](PhysBody* a, PhysBody* b) { return a->getPosition().x < b->getPosition().x; });
+	std::vector<std::pair<PhysBody*, PhysBody*>> pairs;
+	for (size_t i = 0; i < bodies.size(); ++i)
+		for (size_t j = i + 1; j < std::min(bodies.size(), i + 1 + BENCHMARK_N_NEIGHBOURS); ++j)
+			pairs.emplace_back(bodies[i], bodies[j]);
+
+	unsigned int nContacts = 0;
+	while (state.keepRunning()) {
+		for (auto& pair : pairs) {
+			PhysContact contact;
+			if (PhysContactEvaluator::intersects(pair.first, pair.second, contact))
+				++nContacts;
+		}
+		state.addItemsProcessed(pairs.size());
+	}
+	benchmarkSink = nContacts;
+}
+
+#if PHYS_PROFILING
+// Removal of many bodies at once
+// Only removal phase of the step is measured, so it needs the profiler
+static void benchmarkRemoveBurst(BenchmarkState& state, const Distribution distribution, const unsigned int nBodies)
+{
+	const auto burst = std::max(1u, static_cast<unsigned int>(nBodies * BENCHMARK_BURST_SHARE));
+	auto world = createWorld(distribution, nBodies);
+	while (state.keepRunning()) {
+		// New world when too many bodies are removed
+		if (world.bodies.size() < nBodies * 0.8)
+			world = createWorld(distribution, nBodies);
+
+		auto& random = world.world->getRandom();
+		random.shuffle(world.bodies.begin(), world.bodies.end());
+		for (unsigned int i = 0; i < burst; ++i) {
+			world.world->removeBody(world.bodies.back());
+			world.bodies.pop_back();
+		}
+		world.world->step(PHYSICS_UPDATE_INTERVAL);
+		state.addManualTime(world.world->getLastStepProfile().getPhaseTime(PhysPhase::REMOVAL) / 1e6);
+		state.addItemsProcessed(burst);
+	}
+}
+#endif
+
+// Deactivating and activating bodies, which informs the world every time
+static void benchmarkManipulatedChurn(BenchmarkState& state, const Distribution distribution, const unsigned int nBodies)
+{
+	const auto churn = std::max(1u, static_cast<unsigned int>(nBodies * BENCHMARK_BURST_SHARE));
+	auto world = createWorld(distribution, nBodies);
+	auto& random = world.world->getRandom();
+	while (state.keepRunning()) {
+		random.shuffle(world.bodies.begin(), world.bodies.end());
+		const auto start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < churn; ++i) {
+			world.bodies[i]->setActive(false);
+			world.bodies[i]->setActive(true);
+		}
+		state.addManualTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		// Step finds contacts again
+		world.world->step(PHYSICS_UPDATE_INTERVAL);
+		state.addItemsProcessed(churn);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const std::string filter = argc > 1 ? argv[1] : "";
+	const auto minSeconds = argc > 2 ? std::stod(argv[2]) : DEFAULT_MIN_SECONDS;
+	const unsigned int maxBodies = argc > 3 ? std::stoul(argv[3]) : std::numeric_limits<unsigned int>::max();
+
+#if PHYS_PROFILING
+	std::cerr << "Note: built with PHYS_PROFILING, times include profiler overhead, use phys_benchmark for the others" << std::endl;
+#else
+	std::cerr << "Note: built without PHYS_PROFILING, RemoveBurst is only in phys_benchmark_profiled" << std::endl;
+#endif
+
+	// All benchmarks
+	typedef void(*BenchmarkFunction)(BenchmarkState&, Distribution, unsigned int);
+	const std::vector<std::pair<std::string, BenchmarkFunction>> functions = {
+		{ "Step", benchmarkStep },
+		{ "StepFocused", benchmarkStepFocused },
+		{ "Intersects", benchmarkIntersects },
+#if PHYS_PROFILING
+		{ "RemoveBurst", benchmarkRemoveBurst },
+#endif
+		{ "ManipulatedChurn", benchmarkManipulatedChurn }
+	};
+	const Distribution distributions[] = { Distribution::UNIFORM, Distribution::CLUSTERED, Distribution::CORRIDOR };
+	const unsigned int sizes[] = { 100, 1000, 10000, 100000 };
+
+	std::cout << std::left << std::setw(36) << "Benchmark" << std::right << std::setw(16) << "Time (us)" << std::setw(12) << "Iterations" << std::setw(16) << "Items/s" << std::endl;
+	for (const auto& function : functions)
+		for (auto distribution : distributions)
+			for (auto nBodies : sizes) {
+				const auto name = function.first + "/" + getDistributionName(distribution) + "/" + std::to_string(nBodies);
+				if (name.find(filter) == std::string::npos || nBodies > maxBodies)
+					continue;
+
+				// More iterations until it takes long enough
+				unsigned long long iterations = 1;
+				while (true) {
+					BenchmarkState state(iterations);
+					function.second(state, distribution, nBodies);
+					if (state.getSeconds() >= minSeconds || iterations >= 1000000) {
+						std::cout << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(3)
+							<< std::setw(16) << state.getSeconds() / iterations * 1e6 << std::setw(12) << iterations
+							<< std::setprecision(0) << std::setw(16) << (state.getSeconds() > 0 ? state.getItemsProcessed() / state.getSeconds() : 0) << std::endl;
+						break;
+					}
+					// Aim a bit over minimal time
+					iterations = state.getSeconds() > 0 ?
+						std::max(iterations + 1, static_cast<unsigned long long>(iterations * minSeconds * 1.2 / state.getSeconds())) :
+						iterations * 10;
+					iterations = std::min(iterations, 1000000ull);
+				}
+			}
+
+	return 0;
+}
@@ -0,0 +1,147 @@
+#ifndef __WORK_STEALING_POOL_H__
+#define __WORK_STEALING_POOL_H__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Thread pool where every worker has its own queue of tasks
+// Workers take their own tasks from the back and steal other workers' tasks from the front
+// That keeps all cores busy even when tasks take very different time
+class WorkStealingPool
+{
+public:
+	// Add a task to one of the queues
+	void submit(std::function<void()> task)
+	{
+		// Counted before it's queued, a worker can take and finish it right away
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			++queued_;
+			++pending_;
+		}
+		auto& queue = *queues_[nextQueue_++ % queues_.size()];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.tasks.push_back(std::move(task));
+		}
+		workAvailable_.notify_one();
+	}
+
+	// Block until all submitted tasks are finished
+	void wait()
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		allDone_.wait(lock, [this] { return pending_ == 0; });
+	}
+
+	// Return number of worker threads
+	unsigned int getThreadCount() const { return static_cast<unsigned int>(threads_.size()); }
+
+	// Constructor
+	// 0 threads means one per core
+	explicit WorkStealingPool(unsigned int nThreads = 0)
+	{
+		if (nThreads == 0)
+			nThreads = std::max(1u, std::thread::hardware_concurrency());
+
+		for (unsigned int i = 0; i < nThreads; ++i)
+			queues_.push_back(std::make_unique<Queue>());
+		for (unsigned int i = 0; i < nThreads; ++i)
+			threads_.emplace_back(&WorkStealingPool::work, this, i);
+	}
+	// Finish all tasks and stop workers
+	~WorkStealingPool()
+	{
+		wait();
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stopping_ = true;
+		}
+		workAvailable_.notify_all();
+		for (auto& thread : threads_)
+			thread.join();
+	}
+
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+private:
+	// Tasks of one worker
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	// Take own task from the back or steal someone else's from the front
+	bool takeTask(const unsigned int index, std::function<void()>& task)
+	{
+		for (unsigned int i = 0; i < queues_.size(); ++i) {
+			auto& queue = *queues_[(index + i) % queues_.size()];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.tasks.empty())
+				continue;
+			if (i == 0) {
+				task = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+			}
+			else {
+				task = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+			}
+			return true;
+		}
+		return false;
+	}
+
+	// Loop of one worker thread
+	void work(const unsigned int index)
+	{
+		while (true) {
+			std::function<void()> task;
+			if (takeTask(index, task)) {
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					--queued_;
+				}
+				task();
+				std::lock_guard<std::mutex> lock(mutex_);
+				if (--pending_ == 0)
+					allDone_.notify_all();
+				continue;
+			}
+
+			// Nothing to do, sleep until new tasks are submitted
+			std::unique_lock<std::mutex> lock(mutex_);
+			if (stopping_)
+				return;
+			workAvailable_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+			if (stopping_ && queued_ == 0)
+				return;
+		}
+	}
+
+	// One queue per worker
+	std::vector<std::unique_ptr<Queue>> queues_;
+	std::vector<std::thread> threads_;
+	std::atomic<unsigned int> nextQueue_{ 0 };
+
+	// For waiting
+	std::mutex mutex_;
+	std::condition_variable workAvailable_;
+	std::condition_variable allDone_;
+	// Tasks that are not taken by any worker yet
+	size_t queued_ = 0;
+	// Tasks that are not finished yet
+	size_t pending_ = 0;
+	bool stopping_ = false;
+};
+
+#endif // __WORK_STEALING_POOL_H__